@@ -3,6 +3,8 @@
 #include <vector>
 #include <stdexcept>
 #include <iomanip> // for setprecision
+#include <sstream>
+#include <climits>
 using namespace std;
 
 struct date {
@@ -23,9 +25,9 @@ public:
         if (age <= 0 || age > 130) throw invalid_argument("Age must be between 1 and 130.");
     }
     virtual ~person() {}
-    virtual void getter() = 0;
+    virtual void getter(ostream& os = cout) = 0;
     virtual void setter() = 0;
-    virtual void display_details() = 0;
+    virtual void display_details(ostream& os = cout) = 0;
     virtual double calculate_payment() = 0;
 };
 
@@ -48,12 +50,12 @@ public:
 
     virtual ~student() {}
 
-    virtual void getter() override {
-        cout << "Name: " << name << "\nAge: " << age << "\nID: " << id << "\nContact: " << contact_number
+    virtual void getter(ostream& os = cout) override {
+        os << "Name: " << name << "\nAge: " << age << "\nID: " << id << "\nContact: " << contact_number
             << "\nEnrollment Date: " << enrollment_date.day << "/" << enrollment_date.month << "/" << enrollment_date.year
             << "\nProgram: " << program << "\nGPA: " << fixed << setprecision(2) << GPA << "\nCourses: "; //added fixed << setprecision(2)
-        for (const auto& c : courses) cout << c << " ";
-        cout << endl;
+        for (const auto& c : courses) os << c << " ";
+        os << endl;
     }
 
     virtual void setter() override {
@@ -61,8 +63,8 @@ public:
         cout << "Setting student fields is supported.\n";
     }
 
-    virtual void display_details() override {
-        getter();
+    virtual void display_details(ostream& os = cout) override {
+        getter(os);
     }
 
     virtual double calculate_payment() override {
@@ -82,9 +84,9 @@ public:
         : student(name, age, id, contact_number, enroll_date, program, GPA),
         major(major), minor(minor), expected_graduation(grad_date) {}
 
-    void display_details() override {
-        student::display_details();
-        cout << "Major: " << major << ", Minor: " << minor
+    void display_details(ostream& os = cout) override {
+        student::display_details(os);
+        os << "Major: " << major << ", Minor: " << minor
             << ", Graduation: " << expected_graduation.day << "/" << expected_graduation.month << "/" << expected_graduation.year << endl;
     }
 
@@ -102,9 +104,9 @@ public:
         : student(name, age, id, contact_number, enroll_date, program, GPA),
         research_topic(research_topic), advisor(advisor), thesis_title(thesis_title) {}
 
-    void display_details() override {
-        student::display_details();
-        cout << "Research Topic: " << research_topic << ", Advisor: " << advisor << ", Thesis: " << thesis_title << endl;
+    void display_details(ostream& os = cout) override {
+        student::display_details(os);
+        os << "Research Topic: " << research_topic << ", Advisor: " << advisor << ", Thesis: " << thesis_title << endl;
     }
 
     double calculate_payment() override {
@@ -114,19 +116,52 @@ public:
 
 // === Professor Classes ===
 
+class department;
+
+// Rank slots used by department::rank_headcount
+enum professor_rank { RANK_PROFESSOR, RANK_ASSISTANT, RANK_ASSOCIATE, RANK_FULL, RANK_COUNT };
+
 class professor : public person {
+    friend class department;
+
 protected:
     string department, specialization;
     date hire_date;
 
+    class department* owner = nullptr; // Department whose rollup includes this professor
+    size_t owner_slot = 0;             // Position in owner->professors, for O(1) removal
+    double rolled_payment = 0;         // Payment last reported to owner
+    professor_rank rolled_rank = RANK_PROFESSOR; // Rank counted by owner; rank() is not usable from ~professor
+
+    unsigned long version = 0;                  // Bumped on every change to displayed fields
+    unsigned long rendered_version = ULONG_MAX; // Version that `rendered` was built from
+    string rendered;
+
+    // Call after any change that affects calculate_payment()
+    void payment_changed();
+
 public:
     professor(string name, int age, string id, string contact_number, string dept, string spec, date hire)
         : person(name, age, id, contact_number), department(dept), specialization(spec), hire_date(hire) {}
 
-    virtual ~professor() {}
+    virtual ~professor();
+
+    virtual professor_rank rank() const { return RANK_PROFESSOR; }
+
+    // Prints display_details(), re-rendering only after a change
+    void render(ostream& os = cout) {
+        if (rendered_version != version) {
+            ostringstream buf;
+            buf.copyfmt(os);
+            display_details(buf);
+            rendered = buf.str();
+            rendered_version = version;
+        }
+        os << rendered;
+    }
 
-    virtual void getter() override {
-        cout << "Name: " << name << "\nAge: " << age << "\nID: " << id << "\nContact: " << contact_number
+    virtual void getter(ostream& os = cout) override {
+        os << "Name: " << name << "\nAge: " << age << "\nID: " << id << "\nContact: " << contact_number
             << "\nDepartment: " << department << "\nSpecialization: " << specialization
             << "\nHire Date: " << hire_date.day << "/" << hire_date.month << "/" << hire_date.year << endl;
     }
@@ -136,8 +171,8 @@ public:
         cout << "Setting professor fields is supported.\n";
     }
 
-    virtual void display_details() override {
-        getter();
+    virtual void display_details(ostream& os = cout) override {
+        getter(os);
     }
 
     virtual double calculate_payment() override {
@@ -152,9 +187,17 @@ public:
     AssistantProfessor(string name, int age, string id, string contact, string dept, string spec, date hire, int years)
         : professor(name, age, id, contact, dept, spec, hire), years_of_service(years) {}
 
-    void display_details() override {
-        professor::display_details();
-        cout << "Rank: Assistant Professor\nYears of Service: " << years_of_service << endl;
+    professor_rank rank() const override { return RANK_ASSISTANT; }
+
+    void set_years_of_service(int years) {
+        if (years < 0) throw invalid_argument("Years of service cannot be negative.");
+        years_of_service = years;
+        payment_changed();
+    }
+
+    void display_details(ostream& os = cout) override {
+        professor::display_details(os);
+        os << "Rank: Assistant Professor\nYears of Service: " << years_of_service << endl;
     }
 
     double calculate_payment() override {
@@ -169,9 +212,17 @@ public:
     AssociateProfessor(string name, int age, string id, string contact, string dept, string spec, date hire, int pubs)
         : professor(name, age, id, contact, dept, spec, hire), publications(pubs) {}
 
-    void display_details() override {
-        professor::display_details();
-        cout << "Rank: Associate Professor\nPublications: " << publications << endl;
+    professor_rank rank() const override { return RANK_ASSOCIATE; }
+
+    void set_publications(int pubs) {
+        if (pubs < 0) throw invalid_argument("Publications cannot be negative.");
+        publications = pubs;
+        payment_changed();
+    }
+
+    void display_details(ostream& os = cout) override {
+        professor::display_details(os);
+        os << "Rank: Associate Professor\nPublications: " << publications << endl;
     }
 
     double calculate_payment() override {
@@ -186,9 +237,17 @@ public:
     FullProfessor(string name, int age, string id, string contact, string dept, string spec, date hire, double grants)
         : professor(name, age, id, contact, dept, spec, hire), research_grants(grants) {}
 
-    void display_details() override {
-        professor::display_details();
-        cout << "Rank: Full Professor\nResearch Grants: $" << fixed << setprecision(2) << research_grants << endl; //added fixed << setprecision(2)
+    professor_rank rank() const override { return RANK_FULL; }
+
+    void set_research_grants(double grants) {
+        if (grants < 0) throw invalid_argument("Research grants cannot be negative.");
+        research_grants = grants;
+        payment_changed();
+    }
+
+    void display_details(ostream& os = cout) override {
+        professor::display_details(os);
+        os << "Rank: Full Professor\nResearch Grants: $" << fixed << setprecision(2) << research_grants << endl; //added fixed << setprecision(2)
     }
 
     double calculate_payment() override {
@@ -213,33 +272,114 @@ public:
         cout << "Course: " << title << " (" << code << ") - " << credits << " credits\nDescription: " << description << endl;
         if (instructor) {
             cout << "Instructor: ";
-            instructor->display_details();
+            instructor->render();
         }
     }
 };
 
+// Keeps payroll, per-rank headcount and remaining budget up to date as
+// professors join, leave or change pay, so queries never walk the staff list.
 class department {
 private:
     string name, location;
     double budget;
     vector<professor*> professors;
 
+    double total_payroll = 0;
+    int rank_headcount[RANK_COUNT] = {};
+    bool over_budget = false;
+
+    void apply_delta(double delta) {
+        total_payroll += delta;
+        bool now_over = total_payroll > budget;
+        if (now_over && !over_budget)
+            cerr << "ALERT: Department " << name << " payroll $" << fixed << setprecision(2) << total_payroll
+                << " exceeds budget $" << budget << endl;
+        else if (!now_over && over_budget)
+            cerr << "Department " << name << " payroll is back within budget.\n";
+        over_budget = now_over;
+    }
+
 public:
     department(string name, string location, double budget)
-        : name(name), location(location), budget(budget) {}
+        : name(name), location(location), budget(budget) {
+        if (budget < 0) throw invalid_argument("Budget cannot be negative.");
+    }
+
+    ~department() {
+        for (auto* prof : professors) prof->owner = nullptr;
+    }
 
     void add_professor(professor* prof) {
+        if (!prof) throw invalid_argument("Professor cannot be null.");
+        if (prof->owner) throw invalid_argument("Professor already belongs to a department.");
+        prof->owner = this;
+        prof->owner_slot = professors.size();
+        prof->rolled_payment = prof->calculate_payment();
+        prof->rolled_rank = prof->rank();
         professors.push_back(prof);
+        rank_headcount[prof->rolled_rank]++;
+        apply_delta(prof->rolled_payment);
+    }
+
+    void remove_professor(professor* prof) {
+        if (!prof || prof->owner != this) throw invalid_argument("Professor is not in this department.");
+        // Swap-remove: move the last professor into the freed slot
+        professor* last = professors.back();
+        professors[prof->owner_slot] = last;
+        last->owner_slot = prof->owner_slot;
+        professors.pop_back();
+        rank_headcount[prof->rolled_rank]--;
+        apply_delta(-prof->rolled_payment);
+        prof->owner = nullptr;
+    }
+
+    // Called by professor::payment_changed with the old and new payment
+    void on_payment_changed(professor* prof, double old_payment) {
+        apply_delta(prof->rolled_payment - old_payment);
+    }
+
+    double get_total_payroll() const { return total_payroll; }
+    double get_remaining_budget() const { return budget - total_payroll; }
+    int get_headcount(professor_rank r) const { return rank_headcount[r]; }
+    bool is_over_budget() const { return over_budget; }
+
+    void set_budget(double new_budget) {
+        if (new_budget < 0) throw invalid_argument("Budget cannot be negative.");
+        budget = new_budget;
+        apply_delta(0);
+    }
+
+    void print_rollup() const {
+        cout << "Payroll: $" << fixed << setprecision(2) << total_payroll;
+        if (over_budget) cout << ", OVER BUDGET by $" << total_payroll - budget << endl;
+        else cout << ", Remaining Budget: $" << budget - total_payroll << endl;
+        cout << "Headcount - Professor: " << rank_headcount[RANK_PROFESSOR]
+            << ", Assistant: " << rank_headcount[RANK_ASSISTANT]
+            << ", Associate: " << rank_headcount[RANK_ASSOCIATE]
+            << ", Full: " << rank_headcount[RANK_FULL] << endl;
     }
 
     void getter() {
         cout << "Department: " << name << ", Location: " << location << ", Budget: $" << fixed << setprecision(2) << budget << endl; //added fixed << setprecision(2)
+        print_rollup();
         cout << "Professors:\n";
         for (auto* prof : professors)
-            prof->display_details();
+            prof->render();
     }
 };
 
+professor::~professor() {
+    if (owner) owner->remove_professor(this);
+}
+
+void professor::payment_changed() {
+    version++;
+    double old_payment = rolled_payment;
+    rolled_payment = calculate_payment();
+    if (owner) owner->on_payment_changed(this, old_payment);
+}
+
 // === Test ===
 
 void show_person_details(person* p) {
@@ -269,6 +409,16 @@ int main() {
     cout << "\nDepartment Info:\n";
     cse.getter();
 
+    // Rollup stays current as staff and pay change
+    department ece("ECE", "Block B", 9800);
+    ece.add_professor(&asp); // $9600, within budget
+    asp.set_publications(20); // Raises pay to $10000, pushing ECE payroll over budget
+    fp.set_research_grants(1200000);
+    cse.remove_professor(&ap);
+    cout << "\nUpdated Rollups:\n";
+    cse.print_rollup();
+    ece.print_rollup();
+
     cout << "\nCourse Info:\n";
     cs101.getter();
 
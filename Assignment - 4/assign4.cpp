@@ -3,9 +3,40 @@
 #include <vector>
 #include <stdexcept>
 #include <map>
+#include <unordered_map>
 #include <limits>
 #include <algorithm>
 #include <iomanip> // Required for formatted output
+#include <sstream>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <string_view>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 using namespace std;
 
 // === Custom Exception Hierarchy ===
@@ -29,6 +60,126 @@ public:
     PaymentException(const string& msg) : UniversitySystemException("Payment Error: " + msg) {}
 };
 
+class ServerException : public UniversitySystemException {
+public:
+    ServerException(const string& msg) : UniversitySystemException("Server Error: " + msg) {}
+};
+
+// === Worker Pool ===
+// Fixed set of threads shared by the bulk operations. run() splits a job into
+// numbered tasks, lets the workers and the calling thread drain them, and
+// returns once all are done. Tasks must not call run() themselves.
+class WorkerPool {
+private:
+    vector<thread> workers;
+    mutex run_mutex; // One job at a time
+    mutex m;
+    condition_variable work_cv, done_cv;
+    const function<void(size_t)>* job = nullptr;
+    size_t next_task = 0, total_tasks = 0, pending = 0;
+    exception_ptr failure; // First exception thrown by a task of the current job
+    bool stopping = false;
+
+    // Runs queued tasks until none are left; expects m to be held. A task
+    // that throws cancels the tasks not yet started.
+    void drain(unique_lock<mutex>& lock) {
+        while (job && next_task < total_tasks) {
+            size_t task = next_task++;
+            const auto* fn = job;
+            lock.unlock();
+            exception_ptr error;
+            try {
+                (*fn)(task);
+            }
+            catch (...) {
+                error = current_exception();
+            }
+            lock.lock();
+            if (error && !failure) {
+                failure = error;
+                pending -= total_tasks - next_task;
+                next_task = total_tasks;
+            }
+            if (--pending == 0) done_cv.notify_all();
+        }
+    }
+
+public:
+    explicit WorkerPool(size_t count = thread::hardware_concurrency()) {
+        if (count > 1) count--; // The calling thread works too
+        for (size_t i = 0; i < count; i++) {
+            workers.emplace_back([this] {
+                unique_lock<mutex> lock(m);
+                while (true) {
+                    work_cv.wait(lock, [this] { return stopping || (job && next_task < total_tasks); });
+                    if (stopping) return;
+                    drain(lock);
+                }
+            });
+        }
+    }
+
+    ~WorkerPool() {
+        {
+            lock_guard<mutex> lock(m);
+            stopping = true;
+        }
+        work_cv.notify_all();
+        for (auto& t : workers) t.join();
+    }
+
+    size_t size() const { return workers.size() + 1; }
+
+    void run(size_t tasks, const function<void(size_t)>& fn) {
+        if (tasks == 0) return;
+        lock_guard<mutex> serial(run_mutex);
+        unique_lock<mutex> lock(m);
+        job = &fn;
+        next_task = 0;
+        total_tasks = tasks;
+        pending = tasks;
+        work_cv.notify_all();
+        drain(lock);
+        done_cv.wait(lock, [this] { return pending == 0; });
+        job = nullptr;
+        if (failure) {
+            exception_ptr error = move(failure);
+            failure = nullptr;
+            rethrow_exception(error);
+        }
+    }
+
+    static WorkerPool& shared() {
+        static WorkerPool pool;
+        return pool;
+    }
+};
+
+// Formats records [0, count) into per-chunk buffers on the shared pool and
+// writes the buffers out in order, so the output matches a serial loop.
+// Every record sets its own float formatting, so chunks do not depend on the
+// stream state left by the previous chunk.
+template <typename Format>
+void write_in_parallel(ostream& os, size_t count, Format format_one) {
+    const size_t min_chunk = 256; // Below this, threading costs more than it saves
+    size_t chunks = min(WorkerPool::shared().size() * 4, (count + min_chunk - 1) / min_chunk);
+    if (chunks <= 1) {
+        for (size_t i = 0; i < count; i++) format_one(os, i);
+        return;
+    }
+    size_t per_chunk = (count + chunks - 1) / chunks;
+    vector<ostringstream> buffers(chunks);
+    WorkerPool::shared().run(chunks, [&](size_t c) {
+        buffers[c].copyfmt(os);
+        size_t end = min(count, (c + 1) * per_chunk);
+        for (size_t i = c * per_chunk; i < end; i++) format_one(buffers[c], i);
+    });
+    for (const auto& buf : buffers) os << buf.str();
+    // Leave the stream formatted as the serial loop would have
+    os.flags(buffers.back().flags());
+    os.precision(buffers.back().precision());
+}
+
 // === Basic Struct ===
 struct date {
     int day, month, year;
@@ -44,11 +195,121 @@ struct date {
     }
 };
 
+// === Render Cache ===
+// Identifies what a rendering depends on: the entity's own version, plus the
+// identity and version of one linked entity (e.g. a course's instructor)
+struct RenderKey {
+    uint64_t version = 0;
+    const void* link = nullptr;
+    uint64_t link_version = 0;
+
+    bool operator==(const RenderKey& o) const {
+        return version == o.version && link == o.link && link_version == o.link_version;
+    }
+};
+
+// Memoized formatted text for one entity. The entry is swapped atomically,
+// so parallel report tasks can share it; two tasks racing on a stale entry
+// both render the same text. Copies start empty.
+class RenderCache {
+private:
+    struct Entry {
+        RenderKey key;
+        string text;
+        ios_base::fmtflags flags; // Stream state the render left behind
+        streamsize precision;
+    };
+
+    mutable shared_ptr<const Entry> entry;
+
+public:
+    RenderCache() = default;
+    RenderCache(const RenderCache&) {}
+    RenderCache& operator=(const RenderCache&) {
+        atomic_store(&entry, shared_ptr<const Entry>());
+        return *this;
+    }
+
+    template <typename Render>
+    void write(ostream& os, const RenderKey& key, Render render) const {
+        auto cached = atomic_load(&entry);
+        if (!cached || !(cached->key == key)) {
+            ostringstream buf;
+            buf.copyfmt(os);
+            render(buf);
+            cached = make_shared<const Entry>(Entry{ key, buf.str(), buf.flags(), buf.precision() });
+            atomic_store(&entry, cached);
+        }
+        os << cached->text;
+        os.flags(cached->flags);
+        os.precision(cached->precision);
+    }
+};
+
+// === Integrity Digests ===
+// Order-independent checksum over a set of (student, item) facts, split into
+// shards by student ID. Adding or removing a fact is O(1), so each structure
+// keeps its own digest current as it mutates. Two structures that should hold
+// the same facts can then be compared shard by shard without walking them.
+class ShardedDigest {
+public:
+    static const size_t SHARDS = 64;
+
+    // FNV-1a: unlike std::hash it is the same in every run and build, so
+    // digests can be checked against a restored copy
+    static uint64_t stable_hash(string_view text) {
+        uint64_t h = 0xcbf29ce484222325ULL;
+        for (unsigned char c : text) h = (h ^ c) * 0x100000001b3ULL;
+        return h;
+    }
+
+    static size_t shard_of(const string& student_id) { return stable_hash(student_id) % SHARDS; }
+
+private:
+    uint64_t sums[SHARDS] = {};
+    uint64_t counts[SHARDS] = {};
+
+    static uint64_t mix(uint64_t x) { // splitmix64 finalizer
+        x += 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    static uint64_t fact_hash(const string& student_id, const string& item) {
+        return mix(stable_hash(student_id) ^ mix(stable_hash(item)));
+    }
+
+public:
+    void add(const string& student_id, const string& item = "") {
+        size_t sh = shard_of(student_id);
+        sums[sh] += fact_hash(student_id, item);
+        counts[sh]++;
+    }
+
+    void remove(const string& student_id, const string& item = "") {
+        size_t sh = shard_of(student_id);
+        sums[sh] -= fact_hash(student_id, item);
+        counts[sh]--;
+    }
+
+    uint64_t shard(size_t i) const { return mix(sums[i] ^ mix(counts[i])); }
+
+    // Combines all shard values; equal roots mean every shard matches
+    uint64_t root() const {
+        uint64_t r = 0;
+        for (size_t i = 0; i < SHARDS; i++) r = mix(r ^ shard(i));
+        return r;
+    }
+};
+
 // === Person Base ===
+// Identity fields never change once constructed; snapshots read them
+// without locking (see SystemVersion)
 class person {
 protected:
-    string name, id, contact;
-    int age;
+    const string name, id, contact;
+    const int age;
 
 public:
     person(string n, int a, string i, string c) : name(n), age(a), id(i), contact(c) {
@@ -59,43 +320,93 @@ public:
     }
 
     virtual ~person() = default;
-    virtual void display_details() const = 0;
+    virtual void display_details(ostream& os = cout) const = 0;
     virtual double calculate_payment() const = 0;
 
     const string& get_id() const { return id; } // Added getter for ID
     const string& get_name() const { return name; }
+    const string& get_contact() const { return contact; }
+    int get_age() const { return age; }
 };
 
 // === Student (Base) ===
 class student : public person {
 protected:
-    date enrollment_date;
-    string program;
+    const date enrollment_date;
+    const string program;
+    // Write-side bookkeeping, changed under the system's write lock. Snapshots
+    // never read these: they render with the GPA from their own version.
     float GPA;
     vector<string> enrolled_courses;
+    const float entry_gpa; // GPA at admission, shown until course grades exist
+    ShardedDigest* course_ledger = nullptr; // Follows enrolled_courses, for integrity checks
 
 public:
+    static const size_t MAX_COURSES = 5; // Enrolled courses per student per term
+
     student(string n, int a, string i, string c, date d, string p, float g)
-        : person(n, a, i, c), enrollment_date(d), program(p), GPA(g) {
+        : person(n, a, i, c), enrollment_date(d), program(p), GPA(g), entry_gpa(g) {
         if (program.empty()) throw UniversitySystemException("Program cannot be empty.");
         if (GPA < 0 || GPA > 4.0) throw GradeException("GPA must be between 0 and 4.0.  Given value was: " + to_string(g));
     }
 
-    void display_details() const override {
-        cout << "Student: " << name << ", ID: " << id << ", Age: " << age
+    void display_details(ostream& os = cout) const override {
+        display_with_gpa(os, GPA);
+    }
+
+    // Prints the details with the given GPA, so snapshots can show the GPA
+    // as of their version
+    virtual void display_with_gpa(ostream& os, float gpa) const {
+        os << "Student: " << name << ", ID: " << id << ", Age: " << age
             << ", Enrollment Date: " << enrollment_date << ", Program: " << program
-            << ", GPA: " << fixed << setprecision(2) << GPA << endl; //Use stringstream
+            << ", GPA: " << fixed << setprecision(2) << gpa << endl; //Use stringstream
     }
 
     void enroll_course(const string& course_code) {
-        if (enrolled_courses.size() >= 5)
+        if (enrolled_courses.size() >= MAX_COURSES)
             throw EnrollmentException("Course limit reached for student: " + id);
         if (find(enrolled_courses.begin(), enrolled_courses.end(), course_code) != enrolled_courses.end())
             throw EnrollmentException("Student " + id + " is already enrolled in course " + course_code);
         enrolled_courses.push_back(course_code);
+        if (course_ledger) course_ledger->add(id, course_code);
+    }
+
+    // Swap-remove; course order is not significant
+    void drop_course(const string& course_code) {
+        auto it = find(enrolled_courses.begin(), enrolled_courses.end(), course_code);
+        if (it == enrolled_courses.end())
+            throw EnrollmentException("Student " + id + " not enrolled in course " + course_code);
+        *it = move(enrolled_courses.back());
+        enrolled_courses.pop_back();
+        if (course_ledger) course_ledger->remove(id, course_code);
     }
 
     vector<string> get_courses() const { return enrolled_courses; }
+    size_t course_count() const { return enrolled_courses.size(); }
+
+    // Term rollover: releases the list's storage as well as its contents
+    void clear_courses() {
+        if (course_ledger)
+            for (const auto& code : enrolled_courses) course_ledger->remove(id, code);
+        vector<string>().swap(enrolled_courses);
+    }
+
+    // From now on every change to the course list is recorded in `ledger`,
+    // starting with the courses already on it
+    void attach_course_ledger(ShardedDigest* ledger) {
+        course_ledger = ledger;
+        for (const auto& code : enrolled_courses) ledger->add(id, code);
+    }
+    const string& get_program() const { return program; }
+    const date& get_enrollment_date() const { return enrollment_date; }
+    float get_gpa() const { return GPA; }
+    float get_entry_gpa() const { return entry_gpa; }
+
+    void set_gpa(float g) {
+        if (g < 0 || g > 4.0) throw GradeException("GPA must be between 0 and 4.0.  Given value was: " + to_string(g));
+        GPA = g;
+    }
+    virtual bool is_graduate() const { return false; }
 
     double calculate_payment() const override {
         return 5000.0;
@@ -103,7 +414,7 @@ public:
 };
 
 class GraduateStudent : public student {
-    string advisor, thesis_title;
+    const string advisor, thesis_title;
 
 public:
     GraduateStudent(string n, int a, string i, string c, date d, string p, float g,
@@ -113,9 +424,13 @@ public:
         if (thesis.empty()) throw UniversitySystemException("Thesis title cannot be empty.");
     }
 
-    void display_details() const override {
-        student::display_details();
-        cout << "Graduate | Advisor: " << advisor << ", Thesis: " << thesis_title << endl;
+    const string& get_advisor() const { return advisor; }
+    const string& get_thesis_title() const { return thesis_title; }
+    bool is_graduate() const override { return true; }
+
+    void display_with_gpa(ostream& os, float gpa) const override {
+        student::display_with_gpa(os, gpa);
+        os << "Graduate | Advisor: " << advisor << ", Thesis: " << thesis_title << endl;
     }
 
     double calculate_payment() const override {
@@ -128,6 +443,8 @@ protected:
     string specialization;
     date hire_date;
     double base_salary;
+    uint64_t version = 0; // Bumped by every setter
+    RenderCache render_cache;
 
 public:
     professor(string n, int a, string i, string c, string spec, date h, double salary)
@@ -136,9 +453,25 @@ public:
         if (salary < 0) throw PaymentException("Salary cannot be negative. Given value was: " + to_string(salary));
     }
 
-    void display_details() const override {
-        cout << "Professor: " << name << ", ID: " << id << ", Specialization: " << specialization
-            << ", Hire Date: " << hire_date << ", Salary: " << fixed << setprecision(2) << base_salary << endl;
+    uint64_t get_version() const { return version; }
+
+    void set_specialization(const string& spec) {
+        if (spec.empty()) throw UniversitySystemException("Specialization cannot be empty.");
+        specialization = spec;
+        version++;
+    }
+
+    void set_salary(double salary) {
+        if (salary < 0) throw PaymentException("Salary cannot be negative. Given value was: " + to_string(salary));
+        base_salary = salary;
+        version++;
+    }
+
+    void display_details(ostream& os = cout) const override {
+        render_cache.write(os, { version }, [this](ostream& out) {
+            out << "Professor: " << name << ", ID: " << id << ", Specialization: " << specialization
+                << ", Hire Date: " << hire_date << ", Salary: " << fixed << setprecision(2) << base_salary << endl;
+        });
     }
 
     double calculate_payment() const override {
@@ -146,16 +479,53 @@ public:
     }
 };
 
+// Weekly meeting times as a bitmask: one bit per teaching hour, 08:00-20:00
+// Monday to Friday, so two schedules clash when their AND is non-zero
+class TimeSlots {
+public:
+    static constexpr int DAYS = 5, FIRST_HOUR = 8, HOURS_PER_DAY = 12;
+
+    // Hours [start_hour, start_hour + hours) on one day, day 0 being Monday
+    static uint64_t block(int day, int start_hour, int hours = 1) {
+        if (day < 0 || day >= DAYS || hours <= 0 || start_hour < FIRST_HOUR || start_hour + hours > FIRST_HOUR + HOURS_PER_DAY)
+            throw UniversitySystemException("Meeting time outside the teaching week.");
+        return ((uint64_t(1) << hours) - 1) << (day * HOURS_PER_DAY + start_hour - FIRST_HOUR);
+    }
+
+    // e.g. "Mon 09-11, Wed 09-10"
+    static string describe(uint64_t mask) {
+        static const char* names[DAYS] = { "Mon", "Tue", "Wed", "Thu", "Fri" };
+        string text;
+        for (int day = 0; day < DAYS; day++) {
+            for (int h = 0; h < HOURS_PER_DAY;) {
+                if (!(mask >> (day * HOURS_PER_DAY + h) & 1)) {
+                    h++;
+                    continue;
+                }
+                int start = h;
+                while (h < HOURS_PER_DAY && (mask >> (day * HOURS_PER_DAY + h) & 1)) h++;
+                char buf[24];
+                snprintf(buf, sizeof(buf), "%s %02d-%02d", names[day], FIRST_HOUR + start, FIRST_HOUR + h);
+                text += (text.empty() ? "" : ", ") + string(buf);
+            }
+        }
+        return text;
+    }
+};
+
 class course {
 private:
     string code, title;
     float credits;
     string description;
-    professor* instructor;
+    string instructor_id; // Empty when unassigned; resolved to a record by the reader
+    uint64_t meeting_slots = 0; // TimeSlots mask, 0 when unscheduled
+    uint64_t version = 0; // Bumped by every setter
+    RenderCache render_cache;
 
 public:
     course(string code, string title, float credits, string desc, professor* prof)
-        : code(code), title(title), credits(credits), description(desc), instructor(prof) {
+        : code(code), title(title), credits(credits), description(desc), instructor_id(prof ? prof->get_id() : "") {
         if (code.empty()) throw UniversitySystemException("Course code cannot be empty.");
         if (title.empty()) throw UniversitySystemException("Course title cannot be empty.");
         if (credits <= 0) throw UniversitySystemException("Credits must be positive. Given value was: " + to_string(credits));
@@ -164,29 +534,69 @@ public:
 
     string get_code() const { return code; }
     string get_title() const{return title;}
+    const string& get_instructor_id() const { return instructor_id; }
+    float get_credits() const { return credits; }
+    uint64_t get_version() const { return version; }
+    uint64_t get_meeting_slots() const { return meeting_slots; }
 
-    void display_course() const {
-        cout << "Course: " << title << " (" << code << ") - " << fixed << setprecision(1) << credits << " credits\n";
-        cout << "Description: " << description << endl;
-        if (instructor) {
-            cout << "Instructor: ";
-            instructor->display_details();
-        }
-        else {
-            cout << "No instructor assigned.\n";
-        }
+    void set_meeting_slots(uint64_t slots) {
+        meeting_slots = slots;
+        version++;
+    }
+
+    void set_description(const string& desc) {
+        if (desc.empty()) throw UniversitySystemException("Course description cannot be empty.");
+        description = desc;
+        version++;
+    }
+
+    void set_instructor(const string& professor_id) {
+        instructor_id = professor_id;
+        version++;
+    }
+
+    // `instructor` is the record for instructor_id in the caller's version.
+    // Cached until this course or that record changes.
+    void display_course(const professor* instructor, ostream& os = cout) const {
+        RenderKey key{ version, instructor, instructor ? instructor->get_version() : 0 };
+        render_cache.write(os, key, [this, instructor](ostream& out) {
+            out << "Course: " << title << " (" << code << ") - " << fixed << setprecision(1) << credits << " credits\n";
+            out << "Description: " << description << endl;
+            if (meeting_slots) out << "Meets: " << TimeSlots::describe(meeting_slots) << endl;
+            if (instructor) {
+                out << "Instructor: ";
+                instructor->display_details(out);
+            }
+            else {
+                out << "No instructor assigned.\n";
+            }
+        });
     }
 };
 
 class GradeBook {
 private:
     map<string, float> grades;
+    ShardedDigest digest; // One fact per graded student ID
 
 public:
     void add_grade(string student_id, float grade) {
         if (grade < 0 || grade > 100)
             throw GradeException("Grade must be between 0 and 100. Given value was: " + to_string(grade));
-        grades[student_id] = grade;
+        auto inserted = grades.emplace(student_id, grade);
+        if (inserted.second) digest.add(student_id);
+        else inserted.first->second = grade;
+    }
+
+    bool has_grade(const string& student_id) const { return grades.count(student_id) > 0; }
+    const ShardedDigest& get_digest() const { return digest; }
+
+    // Graded student IDs that fall in the selected shards
+    vector<string> student_ids_in(const vector<bool>& shards) const {
+        vector<string> ids;
+        for (const auto& pair : grades)
+            if (shards[ShardedDigest::shard_of(pair.first)]) ids.push_back(pair.first);
+        return ids;
     }
 
     float get_grade(string student_id) const {
@@ -202,183 +612,2757 @@ public:
         return total / grades.size();
     }
 
-    void display_all_grades() const {
+    template <typename Fn>
+    void for_each_grade(Fn fn) const {
+        for (const auto& pair : grades) fn(pair.first, pair.second);
+    }
+
+    void clear() {
+        grades.clear();
+        digest = ShardedDigest();
+    }
+
+    void display_all_grades(ostream& os = cout) const {
         if (grades.empty()) {
-            cout << "No grades available.\n";
+            os << "No grades available.\n";
             return;
         }
-        for (const auto& pair : grades)
-            cout << "Student ID: " << pair.first << ", Grade: " << fixed << setprecision(2) << pair.second << endl;
+        vector<const pair<const string, float>*> rows;
+        rows.reserve(grades.size());
+        for (const auto& pair : grades) rows.push_back(&pair);
+        write_in_parallel(os, rows.size(), [&](ostream& out, size_t i) { write_row(out, rows[i]->first, rows[i]->second); });
+    }
+
+    static void write_row(ostream& os, const string& student_id, float grade) {
+        os << "Student ID: " << student_id << ", Grade: " << fixed << setprecision(2) << grade << endl;
     }
 };
 
-class EnrollmentManager {
+// === Transcript ===
+// Grades per (student, course) with running credit-weighted totals per
+// student. Setting or changing one grade adjusts the totals by the difference,
+// so GPA never needs a pass over the transcript. Totals are kept in
+// hundredths as integers so repeated updates cannot drift.
+class Transcript {
 private:
-    map<string, vector<string>> course_students;
+    struct Entry {
+        float grade;
+        int64_t credits;        // Hundredths of a credit
+        int64_t quality_points; // Hundredths of a grade point times credits
+    };
+
+    struct Record {
+        unordered_map<string, Entry> courses;
+        int64_t credits = 0;
+        int64_t quality_points = 0;
+    };
+
+    unordered_map<string, Record> records;
+    size_t entry_count = 0;
 
 public:
-    void enroll(string course_code, string student_id) {
-        auto& students = course_students[course_code]; // Get the vector of students for the course
-        if (find(students.begin(), students.end(), student_id) != students.end())
-            throw EnrollmentException("Student " + student_id + " is already enrolled in course " + course_code);
-        if (students.size() >= 50)
-            throw EnrollmentException("Course " + course_code + " is full (Max 50 students).");
-        students.push_back(student_id); // Add the student's ID to the vector
+    // Maps a 0-100 grade onto the 4.0 scale
+    static float grade_points(float grade) {
+        if (grade >= 90) return 4.0f;
+        if (grade >= 80) return 3.0f;
+        if (grade >= 70) return 2.0f;
+        if (grade >= 60) return 1.0f;
+        return 0.0f;
     }
 
-    void drop(string course_code, string student_id) {
-        auto& students = course_students[course_code];
-        auto it = find(students.begin(), students.end(), student_id);
-        if (it == students.end()) throw EnrollmentException("Student " + student_id + " not enrolled in course " + course_code);
-        students.erase(it);
+    static void validate(float grade) {
+        if (!(grade >= 0 && grade <= 100)) // Also rejects NaN
+            throw GradeException("Grade must be between 0 and 100. Given value was: " + to_string(grade));
     }
 
-    void display_enrollment(string course_code) const {
-        cout << "Students enrolled in " << course_code << ": ";
-        const auto& students = course_students.find(course_code); // Find using find()
-        if (students == course_students.end() || students->second.empty()) {
-            cout << "None";
-        }
+    // Records or replaces a grade and returns the student's new GPA
+    float set_grade(const string& student_id, const string& course_code, float credits, float grade) {
+        validate(grade);
+        Record& r = records[student_id];
+        auto inserted = r.courses.emplace(course_code, Entry{});
+        Entry& e = inserted.first->second;
+        if (inserted.second) entry_count++;
         else {
-            for (const auto& id : students->second) {
-                cout << id << " ";
-            }
+            r.credits -= e.credits;
+            r.quality_points -= e.quality_points;
         }
-        cout << endl;
+        e.grade = grade;
+        e.credits = llround(credits * 100);
+        e.quality_points = llround(grade_points(grade) * 100) * e.credits;
+        r.credits += e.credits;
+        r.quality_points += e.quality_points;
+        return gpa(student_id);
     }
-    vector<string> get_enrolled_students(const string& courseCode) const {
-        auto it = course_students.find(courseCode);
-        if (it != course_students.end()) {
-            return it->second;
+
+    float get_grade(const string& student_id, const string& course_code) const {
+        auto r = records.find(student_id);
+        if (r != records.end()) {
+            auto e = r->second.courses.find(course_code);
+            if (e != r->second.courses.end()) return e->second.grade;
         }
-        return {}; // Return an empty vector if the course doesn't exist or has no students.
+        throw GradeException("Grade not found for student " + student_id + " in course " + course_code);
     }
-};
 
-class UniversitySystem {
-private:
-    vector<student*> students;
-    vector<professor*> professors;
-    vector<course*> courses;
-    GradeBook gradebook;
-    EnrollmentManager enrollment_mgr;
+    bool has_grades(const string& student_id) const {
+        auto r = records.find(student_id);
+        return r != records.end() && r->second.credits > 0;
+    }
 
-public:
-    ~UniversitySystem() {
-        for (auto s : students) delete s;
-        for (auto p : professors) delete p;
-        for (auto c : courses) delete c;
-        students.clear();
-        professors.clear();
-        courses.clear();
+    float gpa(const string& student_id) const {
+        auto r = records.find(student_id);
+        if (r == records.end() || r->second.credits == 0) return 0;
+        return float(double(r->second.quality_points) / r->second.credits / 100);
     }
 
-    void add_student(student* s) {
-         if (s == nullptr) {
-            throw UniversitySystemException("Cannot add null student.");
-         }
-        for (const auto& studentPtr : students) {
-            if (studentPtr->get_id() == s->get_id()) {
-                throw UniversitySystemException("Student with ID " + s->get_id() + " already exists.");
-            }
-        }
-        students.push_back(s);
+    // Withdraws a grade and its credits from the totals; false if there was none
+    bool remove_grade(const string& student_id, const string& course_code) {
+        auto r = records.find(student_id);
+        if (r == records.end()) return false;
+        auto e = r->second.courses.find(course_code);
+        if (e == r->second.courses.end()) return false;
+        r->second.credits -= e->second.credits;
+        r->second.quality_points -= e->second.quality_points;
+        r->second.courses.erase(e);
+        entry_count--;
+        return true;
     }
-    void add_professor(professor* p) {
-        if (p == nullptr) {
-            throw UniversitySystemException("Cannot add null professor.");
-        }
-        for (const auto& profPtr : professors) {
-            if (profPtr->get_id() == p->get_id()) {
-                throw UniversitySystemException("Professor with ID " + p->get_id() + " already exists.");
-            }
-        }
-        professors.push_back(p);
+
+    double credits(const string& student_id) const {
+        auto r = records.find(student_id);
+        return r == records.end() ? 0 : r->second.credits / 100.0;
     }
-    void add_course(course* c) {
-        if (c == nullptr) {
-            throw UniversitySystemException("Cannot add null course.");
+
+    size_t size() const { return entry_count; }
+
+    // Folds the term's per-course entries into the running totals; the
+    // grades themselves move to the term archive
+    void close_term() {
+        for (auto& entry : records) unordered_map<string, Entry>().swap(entry.second.courses);
+        entry_count = 0;
+    }
+};
+
+struct CourseGradeRow {
+    string student_id, course_code;
+    float grade;
+};
+
+// Summary of one section's grades
+struct SectionStats {
+    size_t enrolled = 0, graded = 0;
+    float mean = 0, min = 0, max = 0, pass_rate = 0;
+    size_t distribution[5] = {}; // A, B, C, D, F on the Transcript::grade_points bands
+
+    // One pass over a grade column; ungraded rows (negative) are skipped
+    static SectionStats compute(const float* grades, size_t n, float pass_mark) {
+        SectionStats st;
+        st.enrolled = n;
+        float sum = 0, lo = 100, hi = 0;
+        size_t graded = 0, passed = 0;
+        for (size_t i = 0; i < n; i++) {
+            float g = grades[i];
+            bool has = g >= 0;
+            graded += has;
+            sum += has ? g : 0;
+            passed += has && g >= pass_mark;
+            lo = has && g < lo ? g : lo;
+            hi = has && g > hi ? g : hi;
+            int band = 9 - int(g / 10); // 90+ -> 0, ..., below 60 -> 4
+            st.distribution[band < 0 ? 0 : band > 4 ? 4 : band] += has;
         }
-        for (const auto& coursePtr : courses) {
-            if (coursePtr->get_code() == c->get_code()) {
-                throw UniversitySystemException("Course with code " + c->get_code() + " already exists.");
-            }
+        st.graded = graded;
+        if (graded) {
+            st.mean = sum / graded;
+            st.min = lo;
+            st.max = hi;
+            st.pass_rate = 100.0f * passed / graded;
         }
-        courses.push_back(c);
+        return st;
     }
 
-    void enroll_student(const string& course_code, const string& student_id) {
-        // Check if the course exists
-        bool course_exists = false;
-        for (const auto* c : courses) {
-            if (c->get_code() == course_code) {
-                course_exists = true;
-                break;
-            }
+    void print(ostream& os, const string& course_code) const {
+        os << "Course: " << course_code << ", Enrolled: " << enrolled << ", Graded: " << graded
+            << fixed << setprecision(2) << ", Mean: " << mean << ", Min: " << min << ", Max: " << max
+            << ", Pass Rate: " << pass_rate << "%, A/B/C/D/F: " << distribution[0] << "/" << distribution[1]
+            << "/" << distribution[2] << "/" << distribution[3] << "/" << distribution[4] << endl;
+    }
+};
+
+// Two-way enrollment index. Each course keeps its roster and grade column;
+// each student keeps links to their rows. Rows and links point at each other,
+// so a drop swap-removes on both sides in O(1) and the views cannot diverge.
+// The grade columns of all sections sit end to end in one array, CAPACITY
+// slots per section, so an all-courses summary is one sweep over memory.
+class EnrollmentManager {
+public:
+    static constexpr float UNGRADED = -1.0f;
+
+    struct Section;
+    struct StudentLinks;
+
+    // Student side: where this student sits in one course's roster
+    struct Link {
+        Section* section;
+        uint32_t row;
+        uint64_t sequence; // Enrollment order; unlike row, survives swap-removes
+    };
+
+    // Course side: which link in the student's list points back at this row
+    struct Backref {
+        StudentLinks* owner;
+        uint32_t slot;
+    };
+
+    static constexpr size_t CAPACITY = 50;
+
+    // A course roster: owners[i] and grade slot i belong to students[i]
+    struct Section {
+        string code;
+        vector<string> students;
+        uint32_t column = 0; // First grade slot of this section in grade_column
+        vector<Backref> owners;
+        uint32_t held = 0; // Seats reserved by unconfirmed holds
+    };
+
+    struct StudentLinks {
+        vector<Link> links;
+    };
+
+private:
+    // Node-based containers, so Section and StudentLinks addresses stay valid
+    map<string, Section> sections;
+    unordered_map<string, StudentLinks> student_links;
+    ShardedDigest digest; // One fact per (student, course) enrollment
+    vector<float> grade_column; // Slots past a section's roster size hold UNGRADED
+    vector<const Section*> by_column; // Sections in grade_column order
+    uint64_t next_sequence = 0;
+
+    Section& section_for(const string& course_code) {
+        auto inserted = sections.try_emplace(course_code);
+        Section& section = inserted.first->second;
+        if (inserted.second) {
+            section.code = course_code;
+            section.column = grade_column.size();
+            grade_column.resize(grade_column.size() + CAPACITY, UNGRADED);
+            by_column.push_back(&section);
         }
-        if (!course_exists) {
-            throw EnrollmentException("Course with code " + course_code + " does not exist.");
+        return section;
+    }
+
+    float* grade_slots(const Section& s) { return grade_column.data() + s.column; }
+
+    static int find_slot(const StudentLinks& sl, const string& course_code) {
+        for (size_t i = 0; i < sl.links.size(); i++)
+            if (sl.links[i].section->code == course_code) return i;
+        return -1;
+    }
+
+public:
+    EnrollmentManager() = default;
+    EnrollmentManager(const EnrollmentManager&) = delete;
+    EnrollmentManager& operator=(const EnrollmentManager&) = delete;
+
+    // Grade slot i belongs to s.students[i]; UNGRADED until a grade is set
+    const float* grades(const Section& s) const { return grade_column.data() + s.column; }
+
+    // Holds count against capacity; a confirmed hold turns its seat into a row
+    void hold_seat(const string& course_code) {
+        auto& section = section_for(course_code);
+        if (section.students.size() + section.held >= CAPACITY)
+            throw EnrollmentException("Course " + course_code + " is full (Max 50 students).");
+        section.held++;
+    }
+
+    void release_seat(const string& course_code) {
+        auto s = sections.find(course_code);
+        if (s != sections.end() && s->second.held > 0) s->second.held--;
+    }
+
+    // Returns the enrollment's sequence number
+    uint64_t enroll(string course_code, string student_id, bool from_hold = false) {
+        auto& sl = student_links[student_id];
+        if (find_slot(sl, course_code) >= 0)
+            throw EnrollmentException("Student " + student_id + " is already enrolled in course " + course_code);
+        auto& section = section_for(course_code);
+        if (from_hold && section.held > 0) section.held--;
+        else if (section.students.size() + section.held >= CAPACITY)
+            throw EnrollmentException("Course " + course_code + " is full (Max 50 students).");
+        sl.links.push_back({ &section, uint32_t(section.students.size()), next_sequence });
+        section.students.push_back(student_id); // Add the student's ID to the vector
+        section.owners.push_back({ &sl, uint32_t(sl.links.size() - 1) });
+        digest.add(student_id, course_code);
+        return next_sequence++;
+    }
+
+    // Returns the sequence number the dropped enrollment was given
+    uint64_t drop(string course_code, string student_id) {
+        auto found = student_links.find(student_id);
+        int slot = found == student_links.end() ? -1 : find_slot(found->second, course_code);
+        if (slot < 0) throw EnrollmentException("Student " + student_id + " not enrolled in course " + course_code);
+        StudentLinks& sl = found->second;
+        Section& section = *sl.links[slot].section;
+        uint32_t row = sl.links[slot].row;
+        uint64_t sequence = sl.links[slot].sequence;
+
+        // Course side: move the last row into the freed one
+        uint32_t last_row = section.students.size() - 1;
+        float* column = grade_slots(section);
+        if (row != last_row) {
+            section.students[row] = move(section.students[last_row]);
+            column[row] = column[last_row];
+            section.owners[row] = section.owners[last_row];
+            section.owners[row].owner->links[section.owners[row].slot].row = row;
         }
+        section.students.pop_back();
+        column[last_row] = UNGRADED;
+        section.owners.pop_back();
 
-        // Check if the student exists
-        bool student_exists = false;
-        for (const auto* s : students) {
-            if (s->get_id() == student_id) {
-                student_exists = true;
-                break;
-            }
+        // Student side: move the last link into the freed slot
+        uint32_t last_slot = sl.links.size() - 1;
+        if (uint32_t(slot) != last_slot) {
+            sl.links[slot] = sl.links[last_slot];
+            sl.links[slot].section->owners[sl.links[slot].row].slot = slot;
         }
-        if (!student_exists) {
-            throw EnrollmentException("Student with ID " + student_id + " does not exist.");
+        sl.links.pop_back();
+        digest.remove(student_id, course_code);
+        return sequence;
+    }
+
+    void set_grade(const string& course_code, const string& student_id, float grade) {
+        auto found = student_links.find(student_id);
+        int slot = found == student_links.end() ? -1 : find_slot(found->second, course_code);
+        if (slot < 0) throw GradeException("Student " + student_id + " is not enrolled in course " + course_code);
+        const Link& link = found->second.links[slot];
+        grade_slots(*link.section)[link.row] = grade;
+    }
+
+    bool is_enrolled(const string& course_code, const string& student_id) const {
+        auto found = student_links.find(student_id);
+        return found != student_links.end() && find_slot(found->second, course_code) >= 0;
+    }
+
+    const ShardedDigest& get_digest() const { return digest; }
+
+    // Student IDs with enrollments that fall in the selected shards
+    vector<string> student_ids_in(const vector<bool>& shards) const {
+        vector<string> ids;
+        for (const auto& entry : student_links)
+            if (!entry.second.links.empty() && shards[ShardedDigest::shard_of(entry.first)]) ids.push_back(entry.first);
+        return ids;
+    }
+
+    vector<string> get_student_courses(const string& student_id) const {
+        vector<string> codes;
+        auto found = student_links.find(student_id);
+        if (found != student_links.end())
+            for (const auto& link : found->second.links) codes.push_back(link.section->code);
+        return codes;
+    }
+
+    // Course conflict graph: two sections are adjacent when they share a
+    // student. codes[i] names vertex i; neighbour lists are built per section
+    // on the worker pool from each student's links.
+    vector<vector<uint32_t>> conflict_graph(vector<string>& codes) const {
+        unordered_map<const Section*, uint32_t> vertex;
+        vector<const Section*> order;
+        codes.clear();
+        for (const auto& entry : sections) {
+            vertex[&entry.second] = order.size();
+            order.push_back(&entry.second);
+            codes.push_back(entry.first);
         }
-        enrollment_mgr.enroll(course_code, student_id);
-        for (auto* s : students) {
-            if (s->get_id() == student_id) {
-                s->enroll_course(course_code);
-                break;
-            }
+        vector<vector<uint32_t>> adjacent(order.size());
+        WorkerPool::shared().run(order.size(), [&](size_t i) {
+            vector<uint32_t>& out = adjacent[i];
+            for (const auto& id : order[i]->students)
+                for (const auto& link : student_links.at(id).links)
+                    if (link.section != order[i]) out.push_back(vertex.at(link.section));
+            sort(out.begin(), out.end());
+            out.erase(unique(out.begin(), out.end()), out.end());
+        });
+        return adjacent;
+    }
+
+    template <typename Fn>
+    void for_each_section(Fn fn) const {
+        for (const auto& entry : sections) fn(entry.second);
+    }
+
+    // Term rollover; callers must make sure no seat holds are pending
+    void clear() {
+        sections.clear();
+        student_links.clear();
+        grade_column.clear();
+        by_column.clear();
+        digest = ShardedDigest();
+    }
+
+    const Section* find_section(const string& course_code) const {
+        auto s = sections.find(course_code);
+        return s == sections.end() ? nullptr : &s->second;
+    }
+
+    SectionStats section_stats(const string& course_code, float pass_mark = 60) const {
+        const Section* s = find_section(course_code);
+        if (!s) throw EnrollmentException("No enrollment for course " + course_code);
+        return SectionStats::compute(grades(*s), s->students.size(), pass_mark);
+    }
+
+    // Stats for every section, sorted by course code, from one sweep over the
+    // grade column split into contiguous runs of sections on the worker pool
+    vector<pair<string, SectionStats>> all_section_stats(float pass_mark = 60) const {
+        const size_t min_run = 256; // Sections per task; fewer cost more to schedule than to sweep
+        vector<pair<string, SectionStats>> result(by_column.size());
+        size_t runs = min(WorkerPool::shared().size() * 4, (by_column.size() + min_run - 1) / min_run);
+        WorkerPool::shared().run(runs, [&](size_t run) {
+            size_t first = by_column.size() * run / runs, last = by_column.size() * (run + 1) / runs;
+            const float* column = grade_column.data() + first * CAPACITY;
+            for (size_t k = first; k < last; k++, column += CAPACITY)
+                result[k] = { by_column[k]->code, SectionStats::compute(column, by_column[k]->students.size(), pass_mark) };
+        });
+        sort(result.begin(), result.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+        return result;
+    }
+
+    // The section's graded rows with points added, capped to 0-100. Nothing
+    // changes until the caller applies the rows.
+    vector<CourseGradeRow> curved_grades(const string& course_code, float points) const {
+        const Section* s = find_section(course_code);
+        if (!s) throw EnrollmentException("No enrollment for course " + course_code);
+        if (!isfinite(points)) throw GradeException("Curve must be a finite number of points.");
+        vector<CourseGradeRow> rows;
+        const float* column = grades(*s);
+        for (size_t i = 0; i < s->students.size(); i++) {
+            if (column[i] < 0) continue;
+            float curved = column[i] + points;
+            rows.push_back({ s->students[i], course_code, curved > 100 ? 100 : curved < 0 ? 0 : curved });
         }
+        return rows;
     }
 
-    void assign_grade(const string& student_id, float grade) {
-        // Check if the student exists before assigning a grade.
-        bool student_exists = false;
-         for (const auto* s : students) {
-            if (s->get_id() == student_id) {
-                student_exists = true;
-                break;
+    // Roster rows are swap-removed, so this order is not enrollment order;
+    // Snapshot::display_enrollment prints in enrollment order
+    void display_enrollment(string course_code, ostream& os = cout) const {
+        const auto& section = sections.find(course_code); // Find using find()
+        write_roster(os, course_code, section == sections.end() ? nullptr : &section->second.students);
+    }
+
+    static void write_roster(ostream& os, const string& course_code, const vector<string>* students) {
+        os << "Students enrolled in " << course_code << ": ";
+        if (!students || students->empty()) {
+            os << "None";
+        }
+        else {
+            for (const auto& id : *students) {
+                os << id << " ";
             }
         }
-        if (!student_exists) {
-             throw GradeException("Student with ID: " + student_id + " does not exist.");
+        os << endl;
+    }
+    vector<string> get_enrolled_students(const string& courseCode) const {
+        auto it = sections.find(courseCode);
+        if (it != sections.end()) {
+            return it->second.students;
         }
-        gradebook.add_grade(student_id, grade);
+        return {}; // Return an empty vector if the course doesn't exist or has no students.
     }
+};
 
-    void report_all_students() const {
-        if (students.empty()) {
-            cout << "No students available.\n";
-            return;
+// === Versioned Snapshots ===
+// Immutable sorted map. set() copies only the O(log n) nodes on the path to
+// the key, so every older version stays valid and shares the rest. Shape is a
+// treap with priorities taken from the key hash.
+template <typename V>
+class PersistentMap {
+private:
+    struct Node;
+    using NodePtr = shared_ptr<const Node>;
+    struct Node {
+        string key;
+        V value;
+        size_t priority;
+        NodePtr left, right;
+    };
+
+    NodePtr root;
+    size_t count = 0;
+
+    static NodePtr make(const string& key, const V& value, size_t priority, NodePtr left, NodePtr right) {
+        return make_shared<const Node>(Node{ key, value, priority, move(left), move(right) });
+    }
+
+    static NodePtr replace(const NodePtr& t, const string& key, const V& value) {
+        if (key == t->key) return make(key, value, t->priority, t->left, t->right);
+        if (key < t->key) return make(t->key, t->value, t->priority, replace(t->left, key, value), t->right);
+        return make(t->key, t->value, t->priority, t->left, replace(t->right, key, value));
+    }
+
+    // Splits t into keys < key and keys > key; key itself must be absent
+    static pair<NodePtr, NodePtr> split(const NodePtr& t, const string& key) {
+        if (!t) return { nullptr, nullptr };
+        if (t->key < key) {
+            auto parts = split(t->right, key);
+            return { make(t->key, t->value, t->priority, t->left, parts.first), parts.second };
         }
-        cout << "\n--- All Students ---\n";
-        for (const auto* s : students) s->display_details();
+        auto parts = split(t->left, key);
+        return { parts.first, make(t->key, t->value, t->priority, parts.second, t->right) };
     }
 
-    void report_all_courses() const {
-        if (courses.empty()) {
-            cout << "No courses available.\n";
-            return;
+    static NodePtr insert(const NodePtr& t, const string& key, const V& value, size_t priority) {
+        if (!t || priority > t->priority) {
+            auto parts = split(t, key);
+            return make(key, value, priority, parts.first, parts.second);
         }
-        cout << "\n--- All Courses ---\n";
-        for (const auto* c : courses) c->display_course();
+        if (key < t->key) return make(t->key, t->value, t->priority, insert(t->left, key, value, priority), t->right);
+        return make(t->key, t->value, t->priority, t->left, insert(t->right, key, value, priority));
     }
 
-    void report_grades() const {
-        cout << "\n--- All Grades ---\n";
-        gradebook.display_all_grades();
+    // Joins two treaps where every key in a sorts before every key in b
+    static NodePtr merge(const NodePtr& a, const NodePtr& b) {
+        if (!a) return b;
+        if (!b) return a;
+        if (a->priority > b->priority) return make(a->key, a->value, a->priority, a->left, merge(a->right, b));
+        return make(b->key, b->value, b->priority, merge(a, b->left), b->right);
     }
+
+    static NodePtr remove(const NodePtr& t, const string& key) {
+        if (key == t->key) return merge(t->left, t->right);
+        if (key < t->key) return make(t->key, t->value, t->priority, remove(t->left, key), t->right);
+        return make(t->key, t->value, t->priority, t->left, remove(t->right, key));
+    }
+
+    template <typename F>
+    static void walk(const NodePtr& t, F& fn) {
+        if (!t) return;
+        walk(t->left, fn);
+        fn(t->key, t->value);
+        walk(t->right, fn);
+    }
+
+public:
+    const V* find(const string& key) const {
+        const Node* t = root.get();
+        while (t) {
+            if (key == t->key) return &t->value;
+            t = key < t->key ? t->left.get() : t->right.get();
+        }
+        return nullptr;
+    }
+
+    PersistentMap set(const string& key, const V& value) const {
+        PersistentMap next;
+        if (find(key)) {
+            next.root = replace(root, key, value);
+            next.count = count;
+        }
+        else {
+            next.root = insert(root, key, value, hash<string>()(key));
+            next.count = count + 1;
+        }
+        return next;
+    }
+
+    PersistentMap erase(const string& key) const {
+        if (!find(key)) return *this;
+        PersistentMap next;
+        next.root = remove(root, key);
+        next.count = count - 1;
+        return next;
+    }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    // Visits entries in key order
+    template <typename F>
+    void for_each(F fn) const { walk(root, fn); }
+};
+
+// Append-only sequence written by one thread and read from snapshots.
+// Chunks are allocated at full size and never move, so a published view of
+// the first n items stays valid while the writer appends past it.
+template <typename T>
+class AppendLog {
+public:
+    static const size_t CHUNK = 4096;
+    using Directory = vector<shared_ptr<T[]>>;
+
+    struct View {
+        shared_ptr<const Directory> chunks;
+        size_t count = 0;
+
+        size_t size() const { return count; }
+        bool empty() const { return count == 0; }
+        const T& operator[](size_t i) const { return (*chunks)[i / CHUNK][i % CHUNK]; }
+    };
+
+private:
+    View current{ make_shared<const Directory>(), 0 };
+
+public:
+    // Returns the view that includes the new item; publish it to make it visible
+    const View& push_back(const T& item) {
+        if (current.count % CHUNK == 0) {
+            auto grown = make_shared<Directory>(*current.chunks);
+            grown->push_back(shared_ptr<T[]>(new T[CHUNK]));
+            current.chunks = grown;
+        }
+        (*current.chunks)[current.count / CHUNK][current.count % CHUNK] = item;
+        current.count++;
+        return current;
+    }
+
+    const View& view() const { return current; }
+};
+
+// Everything a report reads, frozen at one commit
+struct SystemVersion {
+    uint64_t version = 0;
+    // Shared with the live system; reports read only the const identity
+    // fields, and the GPA comes from gpas below
+    AppendLog<const student*>::View students;
+    // Courses and professors are immutable records: an edit publishes a
+    // copy, so every version keeps the ones it was built with
+    AppendLog<string>::View course_codes; // In the order courses were added
+    PersistentMap<shared_ptr<const course>> courses;
+    PersistentMap<shared_ptr<const professor>> professors;
+    PersistentMap<float> grades;
+    PersistentMap<float> gpas; // Student ID -> GPA, so later GPA changes stay out of older snapshots
+    PersistentMap<PersistentMap<float>> course_grades; // Student ID -> course code -> grade, this term
+    // Course code -> enrollment key -> student ID. Keys sort in enrollment
+    // order, and an enroll or drop copies only one path of each map.
+    PersistentMap<PersistentMap<string>> rosters;
+};
+
+// Point-in-time view of a UniversitySystem. Reading never blocks writers and
+// later commits are not visible. Old versions are freed when the last
+// snapshot holding them goes away. Must not outlive the system it came from.
+class Snapshot {
+private:
+    shared_ptr<const SystemVersion> state;
+
+public:
+    explicit Snapshot(shared_ptr<const SystemVersion> s) : state(move(s)) {}
+
+    uint64_t version() const { return state->version; }
+    const SystemVersion& data() const { return *state; }
+
+    void report_all_students(ostream& os = cout) const {
+        const auto& students = state->students;
+        if (students.empty()) {
+            os << "No students available.\n";
+            return;
+        }
+        os << "\n--- All Students ---\n";
+        write_in_parallel(os, students.size(), [&](ostream& out, size_t i) {
+            students[i]->display_with_gpa(out, *state->gpas.find(students[i]->get_id()));
+        });
+    }
+
+    void report_all_courses(ostream& os = cout) const {
+        const auto& codes = state->course_codes;
+        if (codes.empty()) {
+            os << "No courses available.\n";
+            return;
+        }
+        os << "\n--- All Courses ---\n";
+        write_in_parallel(os, codes.size(), [&](ostream& out, size_t i) {
+            const course& c = **state->courses.find(codes[i]);
+            const auto* instructor = state->professors.find(c.get_instructor_id());
+            c.display_course(instructor ? instructor->get() : nullptr, out);
+        });
+    }
+
+    // Overall grades, then this term's course grades
+    void report_grades(ostream& os = cout) const {
+        os << "\n--- All Grades ---\n";
+        if (state->grades.empty() && state->course_grades.empty()) {
+            os << "No grades available.\n";
+            return;
+        }
+        vector<pair<const string*, float>> rows;
+        rows.reserve(state->grades.size());
+        state->grades.for_each([&](const string& id, float grade) { rows.emplace_back(&id, grade); });
+        write_in_parallel(os, rows.size(), [&](ostream& out, size_t i) { GradeBook::write_row(out, *rows[i].first, rows[i].second); });
+        state->course_grades.for_each([&](const string& id, const PersistentMap<float>& grades) {
+            grades.for_each([&](const string& code, float grade) {
+                os << "Student ID: " << id << ", Course: " << code << ", Grade: " << fixed << setprecision(2) << grade << endl;
+            });
+        });
+    }
+
+    // Students in the order they enrolled
+    void display_enrollment(const string& course_code, ostream& os = cout) const {
+        vector<string> students;
+        if (const auto* roster = state->rosters.find(course_code))
+            roster->for_each([&](const string&, const string& id) { students.push_back(id); });
+        EnrollmentManager::write_roster(os, course_code, &students);
+    }
+};
+
+// === Columnar Export ===
+// Binary layout modelled on Arrow IPC streams, little-endian, every message
+// and buffer 8-byte aligned so a mapped file can be read in place:
+//
+//   "UNICOL01"
+//   message*  : u32 kind, u32 body length, body
+//     SCHEMA  : u32 table, u32 columns, per column { u8 type, u8 dictionary, u16 name length, name }
+//     DICT    : u32 dictionary, u32 count, u32 offsets[count + 1], chars      (new entries only)
+//     BATCH   : u32 table, u32 rows, per column { u32 codec, u32 0, u64 raw length, u64 stored length, data }
+//     END     : empty
+//
+// ID columns are int32 indices into a dictionary that grows by delta
+// messages ahead of the batch that first uses them. Int32 columns can be
+// stored DELTA_RLE (zigzag varint delta/run pairs); other buffers are raw.
+enum class ColumnType : uint8_t { DictInt32, Float32, UInt8, Utf8 };
+enum class ExportTable : uint32_t { Students, Courses, Enrollments, Grades, CourseGrades };
+enum ExportDictionary : uint8_t { DICT_STUDENT, DICT_COURSE, DICT_PROGRAM, DICT_PROFESSOR, DICT_COUNT, DICT_NONE = 255 };
+
+struct ColumnSpec {
+    string name;
+    ColumnType type;
+    uint8_t dictionary = DICT_NONE;
+};
+
+class ColumnarFormat {
+public:
+    static constexpr char MAGIC[9] = "UNICOL01";
+    enum Message : uint32_t { END = 0, SCHEMA = 1, DICT = 2, BATCH = 3 };
+    enum Codec : uint32_t { RAW = 0, DELTA_RLE = 1 };
+
+    static void put_varint(vector<uint8_t>& out, uint64_t v) {
+        for (; v >= 0x80; v >>= 7) out.push_back(uint8_t(v) | 0x80);
+        out.push_back(uint8_t(v));
+    }
+
+    static uint64_t get_varint(const uint8_t*& p, const uint8_t* end) {
+        uint64_t v = 0;
+        for (int shift = 0; p < end; shift += 7) {
+            uint8_t b = *p++;
+            v |= uint64_t(b & 0x7f) << shift;
+            if (!(b & 0x80)) return v;
+        }
+        throw UniversitySystemException("Truncated varint in columnar file.");
+    }
+
+    static void encode_delta_rle(const int32_t* values, size_t n, vector<uint8_t>& out) {
+        int64_t prev = 0;
+        for (size_t i = 0; i < n;) {
+            int64_t delta = int64_t(values[i]) - prev;
+            size_t run = 1;
+            while (i + run < n && int64_t(values[i + run]) - values[i + run - 1] == delta) run++;
+            put_varint(out, (uint64_t(delta) << 1) ^ uint64_t(delta >> 63));
+            put_varint(out, run);
+            prev = values[i + run - 1];
+            i += run;
+        }
+    }
+
+    static void decode_delta_rle(const uint8_t* p, const uint8_t* end, int32_t* out, size_t n) {
+        int64_t value = 0;
+        size_t i = 0;
+        while (p < end && i < n) {
+            uint64_t z = get_varint(p, end);
+            int64_t delta = int64_t(z >> 1) ^ -int64_t(z & 1);
+            for (uint64_t run = get_varint(p, end); run-- && i < n;) out[i++] = int32_t(value += delta);
+        }
+        if (i != n) throw UniversitySystemException("Corrupt DELTA_RLE column in columnar file.");
+    }
+};
+
+// One column of the batch being built; cleared and reused per batch
+struct ColumnBuilder {
+    ColumnType type;
+    vector<int32_t> ints;
+    vector<float> floats;
+    vector<uint8_t> bytes;
+    vector<uint32_t> offsets{ 0 };
+    string chars;
+
+    explicit ColumnBuilder(ColumnType t) : type(t) {}
+
+    void clear() {
+        ints.clear();
+        floats.clear();
+        bytes.clear();
+        offsets.assign(1, 0);
+        chars.clear();
+    }
+};
+
+// Streams tables out in fixed-size batches, so memory stays bounded by the
+// batch size plus the ID dictionaries
+class ColumnarWriter {
+private:
+    ofstream out;
+    bool compress;
+    unordered_map<string, int32_t> dict_index[DICT_COUNT];
+    vector<string> dict_pending[DICT_COUNT];
+    vector<uint8_t> body;
+
+    template <typename T>
+    void put(const T& v) {
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(&v);
+        body.insert(body.end(), p, p + sizeof(T));
+    }
+
+    void pad() { body.resize((body.size() + 7) & ~size_t(7), 0); }
+
+    void emit(uint32_t kind) {
+        pad();
+        uint32_t header[2] = { kind, uint32_t(body.size()) };
+        if (body.size() > UINT32_MAX) throw UniversitySystemException("Columnar message too large; use smaller batches.");
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(body.data()), body.size());
+        if (!out) throw UniversitySystemException("Failed writing columnar export.");
+        body.clear();
+    }
+
+    void put_column(uint32_t codec, const void* data, size_t raw, const vector<uint8_t>* stored = nullptr) {
+        put(codec);
+        put(uint32_t(0));
+        put(uint64_t(raw));
+        put(uint64_t(stored ? stored->size() : raw));
+        const uint8_t* p = stored ? stored->data() : static_cast<const uint8_t*>(data);
+        body.insert(body.end(), p, p + (stored ? stored->size() : raw));
+        pad();
+    }
+
+    void flush_dictionaries() {
+        for (uint32_t d = 0; d < DICT_COUNT; d++) {
+            auto& pending = dict_pending[d];
+            if (pending.empty()) continue;
+            put(d);
+            put(uint32_t(pending.size()));
+            uint32_t offset = 0;
+            put(offset);
+            for (const auto& s : pending) put(offset += s.size());
+            for (const auto& s : pending) body.insert(body.end(), s.begin(), s.end());
+            emit(ColumnarFormat::DICT);
+            pending.clear();
+        }
+    }
+
+public:
+    ColumnarWriter(const string& path, bool compress_ids) : out(path, ios::binary | ios::trunc), compress(compress_ids) {
+        if (!out) throw UniversitySystemException("Cannot create columnar export: " + path);
+        out.write(ColumnarFormat::MAGIC, 8);
+    }
+
+    int32_t encode(uint8_t dictionary, const string& value) {
+        auto inserted = dict_index[dictionary].emplace(value, int32_t(dict_index[dictionary].size()));
+        if (inserted.second) dict_pending[dictionary].push_back(value);
+        return inserted.first->second;
+    }
+
+    void write_schema(ExportTable table, const vector<ColumnSpec>& columns) {
+        put(uint32_t(table));
+        put(uint32_t(columns.size()));
+        for (const auto& c : columns) {
+            put(uint8_t(c.type));
+            put(c.dictionary);
+            put(uint16_t(c.name.size()));
+            body.insert(body.end(), c.name.begin(), c.name.end());
+        }
+        emit(ColumnarFormat::SCHEMA);
+    }
+
+    void write_batch(ExportTable table, vector<ColumnBuilder>& columns, size_t rows) {
+        if (rows == 0) return;
+        flush_dictionaries();
+        put(uint32_t(table));
+        put(uint32_t(rows));
+        vector<uint8_t> packed;
+        for (auto& c : columns) {
+            switch (c.type) {
+            case ColumnType::DictInt32:
+                if (compress) {
+                    packed.clear();
+                    ColumnarFormat::encode_delta_rle(c.ints.data(), rows, packed);
+                    put_column(ColumnarFormat::DELTA_RLE, nullptr, rows * sizeof(int32_t), &packed);
+                }
+                else {
+                    put_column(ColumnarFormat::RAW, c.ints.data(), rows * sizeof(int32_t));
+                }
+                break;
+            case ColumnType::Float32:
+                put_column(ColumnarFormat::RAW, c.floats.data(), rows * sizeof(float));
+                break;
+            case ColumnType::UInt8:
+                put_column(ColumnarFormat::RAW, c.bytes.data(), rows);
+                break;
+            case ColumnType::Utf8: {
+                vector<uint8_t> buf(c.offsets.size() * sizeof(uint32_t) + c.chars.size());
+                memcpy(buf.data(), c.offsets.data(), c.offsets.size() * sizeof(uint32_t));
+                memcpy(buf.data() + c.offsets.size() * sizeof(uint32_t), c.chars.data(), c.chars.size());
+                put_column(ColumnarFormat::RAW, buf.data(), buf.size());
+                break;
+            }
+            }
+            c.clear();
+        }
+        emit(ColumnarFormat::BATCH);
+    }
+
+    void finish() {
+        emit(ColumnarFormat::END);
+        out.flush();
+    }
+};
+
+// Exports a snapshot: students, courses, enrollments, overall grades and
+// per-course grades
+inline void export_columnar(const Snapshot& snap, const string& path, size_t batch_rows = 65536, bool compress = false) {
+    if (batch_rows == 0) throw UniversitySystemException("Batch size must be positive.");
+    const SystemVersion& v = snap.data();
+    ColumnarWriter w(path, compress);
+    vector<ColumnBuilder> cols;
+    size_t rows = 0;
+
+    auto start_table = [&](ExportTable table, const vector<ColumnSpec>& specs) {
+        w.write_schema(table, specs);
+        cols.clear();
+        for (const auto& s : specs) cols.emplace_back(s.type);
+        rows = 0;
+    };
+    auto end_row = [&](ExportTable table) {
+        if (++rows == batch_rows) {
+            w.write_batch(table, cols, rows);
+            rows = 0;
+        }
+    };
+    auto add_text = [](ColumnBuilder& c, const string& s) {
+        c.chars += s;
+        c.offsets.push_back(c.chars.size());
+    };
+
+    start_table(ExportTable::Students, { { "id", ColumnType::DictInt32, DICT_STUDENT }, { "name", ColumnType::Utf8 },
+        { "program", ColumnType::DictInt32, DICT_PROGRAM }, { "gpa", ColumnType::Float32 }, { "graduate", ColumnType::UInt8 } });
+    for (size_t i = 0; i < v.students.size(); i++) {
+        const student* s = v.students[i];
+        cols[0].ints.push_back(w.encode(DICT_STUDENT, s->get_id()));
+        add_text(cols[1], s->get_name());
+        cols[2].ints.push_back(w.encode(DICT_PROGRAM, s->get_program()));
+        cols[3].floats.push_back(*v.gpas.find(s->get_id()));
+        cols[4].bytes.push_back(s->is_graduate());
+        end_row(ExportTable::Students);
+    }
+    w.write_batch(ExportTable::Students, cols, rows);
+
+    start_table(ExportTable::Courses, { { "code", ColumnType::DictInt32, DICT_COURSE }, { "title", ColumnType::Utf8 },
+        { "credits", ColumnType::Float32 }, { "instructor", ColumnType::DictInt32, DICT_PROFESSOR } });
+    for (size_t i = 0; i < v.course_codes.size(); i++) {
+        const course& c = **v.courses.find(v.course_codes[i]);
+        cols[0].ints.push_back(w.encode(DICT_COURSE, c.get_code()));
+        add_text(cols[1], c.get_title());
+        cols[2].floats.push_back(c.get_credits());
+        cols[3].ints.push_back(c.get_instructor_id().empty() ? -1 : w.encode(DICT_PROFESSOR, c.get_instructor_id()));
+        end_row(ExportTable::Courses);
+    }
+    w.write_batch(ExportTable::Courses, cols, rows);
+
+    start_table(ExportTable::Enrollments, { { "course", ColumnType::DictInt32, DICT_COURSE },
+        { "student", ColumnType::DictInt32, DICT_STUDENT } });
+    v.rosters.for_each([&](const string& code, const PersistentMap<string>& roster) {
+        int32_t course_id = w.encode(DICT_COURSE, code);
+        roster.for_each([&](const string&, const string& id) {
+            cols[0].ints.push_back(course_id);
+            cols[1].ints.push_back(w.encode(DICT_STUDENT, id));
+            end_row(ExportTable::Enrollments);
+        });
+    });
+    w.write_batch(ExportTable::Enrollments, cols, rows);
+
+    start_table(ExportTable::Grades, { { "student", ColumnType::DictInt32, DICT_STUDENT }, { "grade", ColumnType::Float32 } });
+    v.grades.for_each([&](const string& id, float grade) {
+        cols[0].ints.push_back(w.encode(DICT_STUDENT, id));
+        cols[1].floats.push_back(grade);
+        end_row(ExportTable::Grades);
+    });
+    w.write_batch(ExportTable::Grades, cols, rows);
+
+    start_table(ExportTable::CourseGrades, { { "student", ColumnType::DictInt32, DICT_STUDENT },
+        { "course", ColumnType::DictInt32, DICT_COURSE }, { "grade", ColumnType::Float32 } });
+    v.course_grades.for_each([&](const string& id, const PersistentMap<float>& grades) {
+        int32_t student_id = w.encode(DICT_STUDENT, id);
+        grades.for_each([&](const string& code, float grade) {
+            cols[0].ints.push_back(student_id);
+            cols[1].ints.push_back(w.encode(DICT_COURSE, code));
+            cols[2].floats.push_back(grade);
+            end_row(ExportTable::CourseGrades);
+        });
+    });
+    w.write_batch(ExportTable::CourseGrades, cols, rows);
+    w.finish();
+}
+
+// Reads an export in place. On Linux the file is memory-mapped and raw
+// columns and dictionary strings point straight into the mapping; only
+// DELTA_RLE columns are decoded into buffers owned by the reader.
+class ColumnarReader {
+public:
+    struct Column {
+        ColumnType type;
+        const void* data; // int32_t[rows], float[rows], uint8_t[rows], or Utf8 offsets
+        const char* chars = nullptr; // Utf8 only
+
+        const int32_t* ints() const { return static_cast<const int32_t*>(data); }
+        const float* floats() const { return static_cast<const float*>(data); }
+        const uint8_t* bytes() const { return static_cast<const uint8_t*>(data); }
+        string_view text(size_t row) const {
+            const uint32_t* off = static_cast<const uint32_t*>(data);
+            return string_view(chars + off[row], off[row + 1] - off[row]);
+        }
+    };
+
+    struct Batch {
+        ExportTable table;
+        uint32_t rows;
+        vector<Column> columns;
+    };
+
+private:
+    const uint8_t* base = nullptr;
+    size_t size = 0;
+    vector<uint8_t> owned_file; // Used when the file cannot be mapped
+    vector<unique_ptr<int32_t[]>> decoded;
+    map<uint32_t, vector<ColumnSpec>> schemas;
+    vector<string_view> dictionaries[DICT_COUNT];
+    vector<Batch> batch_list;
+
+    template <typename T>
+    static T take(const uint8_t*& p, const uint8_t* end) {
+        if (p + sizeof(T) > end) throw UniversitySystemException("Truncated columnar file.");
+        T v;
+        memcpy(&v, p, sizeof(T));
+        p += sizeof(T);
+        return v;
+    }
+
+    static const uint8_t* align8(const uint8_t* p, const uint8_t* start) {
+        return start + ((p - start + 7) & ~ptrdiff_t(7));
+    }
+
+    void parse() {
+        if (size < 8 || memcmp(base, ColumnarFormat::MAGIC, 8) != 0)
+            throw UniversitySystemException("Not a columnar export file.");
+        const uint8_t* p = base + 8;
+        const uint8_t* end = base + size;
+        while (true) {
+            uint32_t kind = take<uint32_t>(p, end), length = take<uint32_t>(p, end);
+            const uint8_t* body_end = p + length;
+            if (body_end > end) throw UniversitySystemException("Truncated columnar file.");
+            if (kind == ColumnarFormat::END) return;
+            if (kind == ColumnarFormat::SCHEMA) {
+                uint32_t table = take<uint32_t>(p, body_end), count = take<uint32_t>(p, body_end);
+                vector<ColumnSpec> specs;
+                for (uint32_t i = 0; i < count; i++) {
+                    ColumnSpec spec;
+                    uint8_t type = take<uint8_t>(p, body_end);
+                    if (type > uint8_t(ColumnType::Utf8)) throw UniversitySystemException("Unknown column type in columnar file.");
+                    spec.type = ColumnType(type);
+                    spec.dictionary = take<uint8_t>(p, body_end);
+                    uint16_t len = take<uint16_t>(p, body_end);
+                    if (len > body_end - p) throw UniversitySystemException("Truncated schema in columnar file.");
+                    spec.name.assign(reinterpret_cast<const char*>(p), len);
+                    p += len;
+                    specs.push_back(spec);
+                }
+                schemas[table] = specs;
+            }
+            else if (kind == ColumnarFormat::DICT) {
+                uint32_t dict = take<uint32_t>(p, body_end), count = take<uint32_t>(p, body_end);
+                if (dict >= DICT_COUNT) throw UniversitySystemException("Unknown dictionary in columnar file.");
+                if ((uint64_t(count) + 1) * sizeof(uint32_t) > uint64_t(body_end - p))
+                    throw UniversitySystemException("Truncated dictionary in columnar file.");
+                const uint8_t* offsets = p;
+                const char* chars = reinterpret_cast<const char*>(p + (uint64_t(count) + 1) * sizeof(uint32_t));
+                uint64_t chars_size = reinterpret_cast<const char*>(body_end) - chars;
+                for (uint32_t i = 0; i < count; i++) {
+                    uint32_t a, b;
+                    memcpy(&a, offsets + uint64_t(i) * 4, 4);
+                    memcpy(&b, offsets + uint64_t(i) * 4 + 4, 4);
+                    if (a > b || b > chars_size) throw UniversitySystemException("Corrupt dictionary in columnar file.");
+                    dictionaries[dict].emplace_back(chars + a, b - a);
+                }
+            }
+            else if (kind == ColumnarFormat::BATCH) {
+                Batch batch;
+                batch.table = ExportTable(take<uint32_t>(p, body_end));
+                batch.rows = take<uint32_t>(p, body_end);
+                auto schema = schemas.find(uint32_t(batch.table));
+                if (schema == schemas.end()) throw UniversitySystemException("Batch before schema in columnar file.");
+                for (const auto& spec : schema->second) {
+                    uint32_t codec = take<uint32_t>(p, body_end);
+                    take<uint32_t>(p, body_end);
+                    uint64_t raw = take<uint64_t>(p, body_end), stored = take<uint64_t>(p, body_end);
+                    if (stored > uint64_t(body_end - p)) throw UniversitySystemException("Truncated column in columnar file.");
+                    Column col{ spec.type, p };
+                    if (codec == ColumnarFormat::DELTA_RLE) {
+                        if (spec.type != ColumnType::DictInt32)
+                            throw UniversitySystemException("DELTA_RLE codec on a non-integer column in columnar file.");
+                        if (raw != uint64_t(batch.rows) * sizeof(int32_t))
+                            throw UniversitySystemException("Corrupt DELTA_RLE column in columnar file.");
+                        decoded.emplace_back(new int32_t[batch.rows]);
+                        ColumnarFormat::decode_delta_rle(p, p + stored, decoded.back().get(), batch.rows);
+                        col.data = decoded.back().get();
+                    }
+                    else if (codec != ColumnarFormat::RAW) {
+                        throw UniversitySystemException("Unknown codec in columnar file.");
+                    }
+                    else if (spec.type == ColumnType::Utf8) {
+                        uint64_t offsets_size = (uint64_t(batch.rows) + 1) * sizeof(uint32_t);
+                        if (stored < offsets_size) throw UniversitySystemException("Truncated text column in columnar file.");
+                        uint64_t chars_size = stored - offsets_size;
+                        uint32_t prev = 0;
+                        for (uint64_t i = 0; i <= batch.rows; i++) {
+                            uint32_t off;
+                            memcpy(&off, p + i * sizeof(uint32_t), sizeof(uint32_t));
+                            if (off < prev || off > chars_size) throw UniversitySystemException("Corrupt text column in columnar file.");
+                            prev = off;
+                        }
+                        col.chars = reinterpret_cast<const char*>(p + offsets_size);
+                    }
+                    else {
+                        uint64_t width = spec.type == ColumnType::UInt8 ? sizeof(uint8_t) : sizeof(int32_t);
+                        if (stored < uint64_t(batch.rows) * width) throw UniversitySystemException("Truncated column in columnar file.");
+                    }
+                    batch.columns.push_back(col);
+                    p = align8(p + stored, base);
+                }
+                batch_list.push_back(move(batch));
+            }
+            p = body_end;
+        }
+    }
+
+public:
+    explicit ColumnarReader(const string& path) {
+#ifdef __linux__
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw UniversitySystemException("Cannot open columnar export: " + path);
+        struct stat st;
+        fstat(fd, &st);
+        size = st.st_size;
+        void* mapped = size ? mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+        close(fd);
+        if (mapped == MAP_FAILED) throw UniversitySystemException("Cannot map columnar export: " + path);
+        base = static_cast<const uint8_t*>(mapped);
+#else
+        ifstream in(path, ios::binary);
+        if (!in) throw UniversitySystemException("Cannot open columnar export: " + path);
+        owned_file.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+        base = owned_file.data();
+        size = owned_file.size();
+#endif
+        try {
+            parse();
+        }
+        catch (...) {
+            release();
+            throw;
+        }
+    }
+
+    ~ColumnarReader() { release(); }
+    ColumnarReader(const ColumnarReader&) = delete;
+    ColumnarReader& operator=(const ColumnarReader&) = delete;
+
+    void release() {
+#ifdef __linux__
+        if (base) munmap(const_cast<uint8_t*>(base), size);
+#endif
+        base = nullptr;
+    }
+
+    const vector<Batch>& batches() const { return batch_list; }
+    const vector<ColumnSpec>& schema(ExportTable table) const { return schemas.at(uint32_t(table)); }
+
+    string_view lookup(uint8_t dictionary, int32_t index) const {
+        if (index < 0) return string_view();
+        return dictionaries[dictionary].at(index);
+    }
+
+    size_t row_count(ExportTable table) const {
+        size_t n = 0;
+        for (const auto& b : batch_list)
+            if (b.table == table) n += b.rows;
+        return n;
+    }
+};
+
+// === Change Feed ===
+// Ordered log of every committed change, so downstream services can read
+// deltas instead of diffing full reports. The newest `capacity` events stay in
+// a ring buffer; with a file sink attached, every event is also appended to a
+// text file that replay() can read back from any sequence number. Writers
+// append only after publishing the version that holds the change, so a reader
+// woken by an event always finds it in snapshot().
+enum class ChangeType : uint8_t { StudentAdded, ProfessorAdded, CourseAdded, Enrolled, Dropped, GradeSet, CourseGradeSet,
+    ProfessorUpdated, CourseUpdated, SeatHeld, HoldReleased, HoldLapsed, TermRolledOver };
+
+struct ChangeEvent {
+    uint64_t sequence = 0;
+    ChangeType type = ChangeType::StudentAdded;
+    string entity_id;   // Student, professor or course ID
+    string course_code; // Empty unless the change concerns a course enrollment or grade
+    float grade = 0;
+};
+
+class ChangeFeed {
+private:
+    static constexpr const char* TYPE_NAMES[] = { "student_added", "professor_added", "course_added",
+        "enrolled", "dropped", "grade_set", "course_grade_set", "professor_updated", "course_updated",
+        "seat_held", "hold_released", "hold_lapsed", "term_rolled_over" };
+
+    vector<ChangeEvent> ring;
+    uint64_t next_sequence = 1;
+    uint64_t first_sequence_held = 1; // First sequence of this run; earlier ones are only in the file
+    mutable mutex m;
+    condition_variable appended;
+    ofstream sink;
+
+    static void write_event(ostream& os, const ChangeEvent& e) {
+        os << e.sequence << '\t' << TYPE_NAMES[int(e.type)] << '\t' << e.entity_id << '\t' << e.course_code
+            << '\t' << fixed << setprecision(2) << e.grade << '\n';
+    }
+
+    uint64_t oldest() const {
+        return max(first_sequence_held, next_sequence > ring.size() ? next_sequence - ring.size() : 1);
+    }
+
+    static uint64_t parse_sequence(const string& text, const string& line) {
+        try {
+            size_t used;
+            uint64_t seq = stoull(text, &used);
+            if (used == text.size()) return seq;
+        }
+        catch (const logic_error&) {} // invalid_argument or out_of_range
+        throw UniversitySystemException("Malformed change feed line: " + line);
+    }
+
+public:
+    explicit ChangeFeed(size_t capacity = 65536) : ring(capacity) {
+        if (capacity == 0) throw UniversitySystemException("Change feed capacity must be positive.");
+    }
+
+    // Appends to `path`, numbering on from the last event already in it so
+    // events from different runs never share a sequence number. Must be
+    // called before the first change is recorded.
+    void open_sink(const string& path) {
+        uint64_t last = 0;
+        ifstream existing(path);
+        for (string line; getline(existing, line);)
+            if (!line.empty()) last = parse_sequence(line.substr(0, line.find('\t')), line);
+        lock_guard<mutex> lock(m);
+        if (next_sequence != first_sequence_held)
+            throw UniversitySystemException("The change feed file must be opened before any change is recorded.");
+        if (sink.is_open()) throw UniversitySystemException("A change feed file is already open.");
+        sink.open(path, ios::app);
+        if (!sink) throw UniversitySystemException("Cannot open change feed file: " + path);
+        next_sequence = first_sequence_held = last + 1;
+    }
+
+    void flush_sink() {
+        lock_guard<mutex> lock(m);
+        if (sink.is_open()) sink.flush();
+    }
+
+    uint64_t append(ChangeType type, const string& entity_id, const string& course_code = "", float grade = 0) {
+        lock_guard<mutex> lock(m);
+        ChangeEvent& e = ring[next_sequence % ring.size()];
+        e.sequence = next_sequence++;
+        e.type = type;
+        e.entity_id = entity_id;
+        e.course_code = course_code;
+        e.grade = grade;
+        if (sink.is_open()) write_event(sink, e);
+        appended.notify_all();
+        return e.sequence;
+    }
+
+    // Returns up to `max` events starting at sequence `from`. Throws if `from`
+    // has already been overwritten, in which case the reader must resync
+    // from a full report or from the file sink.
+    vector<ChangeEvent> read(uint64_t from, size_t max) const {
+        lock_guard<mutex> lock(m);
+        if (from < oldest())
+            throw UniversitySystemException("Change feed position " + to_string(from) + " was overwritten; oldest is " + to_string(oldest()));
+        vector<ChangeEvent> batch;
+        for (uint64_t seq = from; seq < next_sequence && batch.size() < max; seq++)
+            batch.push_back(ring[seq % ring.size()]);
+        return batch;
+    }
+
+    // Blocks until an event at or after `from` exists or the timeout passes
+    bool wait_for(uint64_t from, chrono::milliseconds timeout) {
+        unique_lock<mutex> lock(m);
+        return appended.wait_for(lock, timeout, [&] { return next_sequence > from; });
+    }
+
+    uint64_t first_sequence() const {
+        lock_guard<mutex> lock(m);
+        return oldest();
+    }
+
+    uint64_t last_sequence() const {
+        lock_guard<mutex> lock(m);
+        return next_sequence - 1;
+    }
+
+    static void print(ostream& os, const ChangeEvent& e) { write_event(os, e); }
+
+    // Reads events back from a file written by the sink
+    static vector<ChangeEvent> replay(const string& path, uint64_t from = 1) {
+        ifstream in(path);
+        if (!in) throw UniversitySystemException("Cannot open change feed file: " + path);
+        vector<ChangeEvent> events;
+        string line;
+        while (getline(in, line)) {
+            istringstream fields(line);
+            ChangeEvent e;
+            string seq, type, grade;
+            getline(fields, seq, '\t');
+            getline(fields, type, '\t');
+            getline(fields, e.entity_id, '\t');
+            getline(fields, e.course_code, '\t');
+            getline(fields, grade);
+            auto name = find_if(begin(TYPE_NAMES), end(TYPE_NAMES), [&](const char* n) { return type == n; });
+            if (seq.empty() || grade.empty() || name == end(TYPE_NAMES))
+                throw UniversitySystemException("Malformed change feed line: " + line);
+            e.sequence = parse_sequence(seq, line);
+            e.type = ChangeType(name - begin(TYPE_NAMES));
+            try {
+                e.grade = stof(grade);
+            }
+            catch (const logic_error&) {
+                throw UniversitySystemException("Malformed change feed line: " + line);
+            }
+            if (e.sequence >= from) events.push_back(e);
+        }
+        return events;
+    }
+};
+
+// Reads a feed in batches, remembering its position
+class ChangeSubscriber {
+private:
+    ChangeFeed& feed;
+    uint64_t position;
+
+public:
+    // Starts at the oldest event still held in memory
+    explicit ChangeSubscriber(ChangeFeed& f) : feed(f), position(f.first_sequence()) {}
+    ChangeSubscriber(ChangeFeed& f, uint64_t from) : feed(f), position(from) {}
+
+    vector<ChangeEvent> poll(size_t max = 1024) {
+        auto batch = feed.read(position, max);
+        if (!batch.empty()) position = batch.back().sequence + 1;
+        return batch;
+    }
+
+    // Waits up to `timeout` for new events, then polls
+    vector<ChangeEvent> poll_wait(chrono::milliseconds timeout, size_t max = 1024) {
+        feed.wait_for(position, timeout);
+        return poll(max);
+    }
+
+    uint64_t next_position() const { return position; }
+};
+
+// === Seat Holds ===
+// Hierarchical timer wheel: LEVELS wheels of 64 slots, each slot of level n
+// spanning 64^n ticks. A timer goes into the coarsest level its delay needs
+// and is pushed down a level each time that slot comes round, so scheduling,
+// cancelling and firing are O(1) per timer, with no scans of pending timers.
+// Delays past the top level are parked in it and re-placed on cascade.
+// Advancing skips straight past spans where the lower levels are empty.
+class TimerWheel {
+public:
+    using Handle = uint32_t;
+    static constexpr int LEVELS = 4, BITS = 6, SLOTS = 1 << BITS;
+
+private:
+    static constexpr uint32_t NIL = UINT32_MAX;
+
+    struct Node {
+        uint64_t expires;
+        uint32_t payload;
+        uint32_t prev, next; // Bucket list, or free list through next
+        uint32_t bucket;
+    };
+
+    vector<Node> nodes;
+    uint32_t free_head = NIL;
+    vector<uint32_t> heads = vector<uint32_t>(LEVELS * SLOTS, NIL);
+    uint64_t now = 0;
+    size_t active = 0;
+    size_t level_count[LEVELS] = {};
+
+    // Cascading timers may land on the tick being processed; new ones start at the next tick
+    void link(uint32_t n, uint64_t earliest) {
+        uint64_t e = max(nodes[n].expires, earliest);
+        uint64_t delta = e - now;
+        int level = 0;
+        while (level < LEVELS - 1 && delta >= uint64_t(1) << (BITS * (level + 1))) level++;
+        if (delta >= uint64_t(1) << (BITS * LEVELS)) e = now + (uint64_t(1) << (BITS * LEVELS)) - 1;
+        uint32_t bucket = level * SLOTS + ((e >> (BITS * level)) & (SLOTS - 1));
+        Node& node = nodes[n];
+        node.bucket = bucket;
+        level_count[level]++;
+        node.prev = NIL;
+        node.next = heads[bucket];
+        if (node.next != NIL) nodes[node.next].prev = n;
+        heads[bucket] = n;
+    }
+
+    void unlink(uint32_t n) {
+        Node& node = nodes[n];
+        if (node.prev != NIL) nodes[node.prev].next = node.next;
+        else heads[node.bucket] = node.next;
+        if (node.next != NIL) nodes[node.next].prev = node.prev;
+        level_count[node.bucket / SLOTS]--;
+    }
+
+    // Detaches a whole slot and returns the first node of its list
+    uint32_t take(uint32_t bucket) {
+        uint32_t first = heads[bucket];
+        heads[bucket] = NIL;
+        for (uint32_t n = first; n != NIL; n = nodes[n].next) level_count[bucket / SLOTS]--;
+        return first;
+    }
+
+    void free_node(uint32_t n) {
+        nodes[n].next = free_head;
+        free_head = n;
+        active--;
+    }
+
+public:
+    explicit TimerWheel(uint64_t start = 0) : now(start) {}
+
+    uint64_t current() const { return now; }
+    size_t size() const { return active; }
+
+    Handle schedule(uint64_t expires, uint32_t payload) {
+        uint32_t n;
+        if (free_head != NIL) {
+            n = free_head;
+            free_head = nodes[n].next;
+        }
+        else {
+            n = nodes.size();
+            nodes.emplace_back();
+        }
+        nodes[n].expires = expires;
+        nodes[n].payload = payload;
+        link(n, now + 1);
+        active++;
+        return n;
+    }
+
+    // The handle must belong to a timer that has not fired
+    void cancel(Handle n) {
+        unlink(n);
+        free_node(n);
+    }
+
+    // Moves the clock to `until`, calling fire(payload) for each timer due
+    template <typename Fire>
+    void advance(uint64_t until, Fire fire) {
+        vector<uint32_t> due;
+        while (now < until) {
+            if (active == 0) {
+                now = until;
+                break;
+            }
+            // Nothing fires or cascades before the next boundary of the lowest occupied level
+            int lowest = 0;
+            while (level_count[lowest] == 0) lowest++;
+            if (lowest > 0) {
+                uint64_t boundary = ((now >> (BITS * lowest)) + 1) << (BITS * lowest);
+                now = min(until, boundary - 1);
+                if (now == until) break;
+            }
+            now++;
+            int rolled = 0;
+            while (rolled + 1 < LEVELS && (now & ((uint64_t(1) << (BITS * (rolled + 1))) - 1)) == 0) rolled++;
+            for (int level = rolled; level >= 1; level--) {
+                for (uint32_t n = take(level * SLOTS + ((now >> (BITS * level)) & (SLOTS - 1))); n != NIL;) {
+                    uint32_t next = nodes[n].next;
+                    link(n, now);
+                    n = next;
+                }
+            }
+            due.clear();
+            for (uint32_t n = take(now & (SLOTS - 1)); n != NIL;) {
+                uint32_t next = nodes[n].next;
+                due.push_back(nodes[n].payload);
+                free_node(n);
+                n = next;
+            }
+            for (uint32_t payload : due) fire(payload); // Safe to schedule or cancel from here
+        }
+    }
+};
+
+// Unconfirmed seat reservations keyed by (student, course), each with a
+// timer on the wheel. Ticks are seconds.
+class SeatHoldBook {
+public:
+    struct Hold {
+        string student_id, course_code;
+        uint64_t expires = 0;
+        TimerWheel::Handle timer = 0;
+    };
+
+private:
+    vector<Hold> pool;
+    vector<uint32_t> free_slots;
+    unordered_map<string, uint32_t> by_key;
+    unordered_map<string, vector<uint32_t>> by_student; // A student holds at most a few seats
+    TimerWheel wheel;
+
+    static string key(const string& student_id, const string& course_code) { return student_id + '\n' + course_code; }
+
+    void erase(uint32_t slot) {
+        by_key.erase(key(pool[slot].student_id, pool[slot].course_code));
+        auto held = by_student.find(pool[slot].student_id);
+        held->second.erase(std::find(held->second.begin(), held->second.end(), slot));
+        if (held->second.empty()) by_student.erase(held);
+        pool[slot] = Hold();
+        free_slots.push_back(slot);
+    }
+
+public:
+    explicit SeatHoldBook(uint64_t now = 0) : wheel(now) {}
+
+    const Hold* find(const string& student_id, const string& course_code) const {
+        auto it = by_key.find(key(student_id, course_code));
+        return it == by_key.end() ? nullptr : &pool[it->second];
+    }
+
+    void place(const string& student_id, const string& course_code, uint64_t expires) {
+        uint32_t slot;
+        if (!free_slots.empty()) {
+            slot = free_slots.back();
+            free_slots.pop_back();
+        }
+        else {
+            slot = pool.size();
+            pool.emplace_back();
+        }
+        pool[slot] = { student_id, course_code, expires, wheel.schedule(expires, slot) };
+        by_key[key(student_id, course_code)] = slot;
+        by_student[student_id].push_back(slot);
+    }
+
+    // Courses the student currently holds seats in
+    vector<string> held_by(const string& student_id) const {
+        vector<string> codes;
+        auto held = by_student.find(student_id);
+        if (held != by_student.end())
+            for (uint32_t slot : held->second) codes.push_back(pool[slot].course_code);
+        return codes;
+    }
+
+    // Returns false when there was no such hold
+    bool release(const string& student_id, const string& course_code) {
+        auto it = by_key.find(key(student_id, course_code));
+        if (it == by_key.end()) return false;
+        wheel.cancel(pool[it->second].timer);
+        erase(it->second);
+        return true;
+    }
+
+    // Expires every hold due by `now`, calling lapse(hold) before removing it
+    template <typename Lapse>
+    void expire_until(uint64_t now, Lapse lapse) {
+        wheel.advance(now, [&](uint32_t slot) {
+            lapse(static_cast<const Hold&>(pool[slot]));
+            erase(slot);
+        });
+    }
+
+    size_t size() const { return by_key.size(); }
+};
+
+// === Term Archive ===
+// Fixed-width unsigned values packed back to back into 64-bit words
+class BitPackedArray {
+private:
+    vector<uint64_t> words;
+    size_t count = 0;
+    uint32_t width;
+
+public:
+    explicit BitPackedArray(uint32_t bits = 1) : width(bits) {
+        if (bits == 0 || bits > 64) throw UniversitySystemException("Bit width must be between 1 and 64.");
+    }
+
+    void push_back(uint64_t v) {
+        size_t bit = count * width, w = bit / 64, off = bit % 64;
+        if (w + 1 >= words.size()) words.resize(w + 2, 0); // One spare word, so reads may straddle
+        words[w] |= v << off;
+        if (off + width > 64) words[w + 1] |= v >> (64 - off);
+        count++;
+    }
+
+    uint64_t operator[](size_t i) const {
+        size_t bit = i * width, w = bit / 64, off = bit % 64;
+        uint64_t v = words[w] >> off;
+        if (off + width > 64) v |= words[w + 1] << (64 - off);
+        return width == 64 ? v : v & ((uint64_t(1) << width) - 1);
+    }
+
+    size_t size() const { return count; }
+    void shrink_to_fit() { words.shrink_to_fit(); }
+    size_t memory_bytes() const { return words.capacity() * sizeof(uint64_t); }
+};
+
+// Sorted, deduplicated strings in one buffer; an entry's index is its code
+class SortedDictionary {
+private:
+    string chars;
+    vector<uint32_t> offsets{ 0 };
+
+public:
+    SortedDictionary() = default;
+
+    explicit SortedDictionary(vector<string> values) {
+        sort(values.begin(), values.end());
+        values.erase(unique(values.begin(), values.end()), values.end());
+        offsets.reserve(values.size() + 1);
+        for (const auto& v : values) {
+            chars += v;
+            offsets.push_back(chars.size());
+        }
+        chars.shrink_to_fit();
+    }
+
+    size_t size() const { return offsets.size() - 1; }
+
+    string_view operator[](size_t i) const {
+        return string_view(chars).substr(offsets[i], offsets[i + 1] - offsets[i]);
+    }
+
+    // Index of value, or -1
+    int64_t find(string_view value) const {
+        size_t lo = 0, hi = size();
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            if ((*this)[mid] < value) lo = mid + 1;
+            else hi = mid;
+        }
+        return lo < size() && (*this)[lo] == value ? int64_t(lo) : -1;
+    }
+
+    size_t memory_bytes() const { return chars.capacity() + offsets.capacity() * sizeof(uint32_t); }
+};
+
+struct ArchiveRow {
+    string course_code, student_id;
+    float grade; // Negative when ungraded
+};
+
+// One closed term, frozen at rollover. Student IDs and course codes are
+// dictionary-encoded; grades are 7.1 fixed point (half-mark steps) in 8
+// bits. Enrollment rows are grouped by course and sorted by student, each
+// packed as student code and grade in just enough bits, so a term of
+// thousands of rows costs a few bytes per row. Read through Cursor.
+class TermArchive {
+public:
+    static constexpr uint8_t NO_GRADE = 255;
+
+    static uint8_t quantize(float grade) {
+        return grade < 0 ? NO_GRADE : uint8_t(lround(min(grade, 100.0f) * 2));
+    }
+
+    static float dequantize(uint8_t q) { return q / 2.0f; }
+
+private:
+    string term;
+    SortedDictionary students, courses;
+    vector<uint32_t> course_start; // Rows of course c are [course_start[c], course_start[c + 1])
+    BitPackedArray rows;           // student code << 8 | grade
+    BitPackedArray overall;        // GradeBook grade per student code
+
+    static uint32_t bits_for(size_t values) {
+        uint32_t bits = 1;
+        while (bits < 56 && (size_t(1) << bits) < values) bits++;
+        return bits;
+    }
+
+public:
+    // Sequential reader over one course, one student or the whole term
+    class Cursor {
+    private:
+        const TermArchive* archive;
+        size_t next_row, end_row, row = 0;
+        size_t course;
+        int64_t student; // -1 reads every student
+
+    public:
+        Cursor(const TermArchive* a, size_t begin, size_t end, size_t first_course, int64_t student_code)
+            : archive(a), next_row(begin), end_row(end), course(first_course), student(student_code) {}
+
+        // Moves to the next matching row; false once the cursor is exhausted
+        bool next() {
+            while (next_row < end_row) {
+                row = next_row++;
+                while (archive->course_start[course + 1] <= row) course++;
+                if (student < 0 || int64_t(archive->rows[row] >> 8) == student) return true;
+            }
+            return false;
+        }
+
+        string_view course_code() const { return archive->courses[course]; }
+        string_view student_id() const { return archive->students[archive->rows[row] >> 8]; }
+        bool graded() const { return (archive->rows[row] & 0xff) != NO_GRADE; }
+        float grade() const { return dequantize(archive->rows[row] & 0xff); }
+    };
+
+    TermArchive(string term_name, vector<ArchiveRow> enrollment, const vector<pair<string, float>>& overall_grades)
+        : term(move(term_name)) {
+        vector<string> ids, codes;
+        for (const auto& r : enrollment) {
+            ids.push_back(r.student_id);
+            codes.push_back(r.course_code);
+        }
+        for (const auto& g : overall_grades) ids.push_back(g.first);
+        students = SortedDictionary(move(ids));
+        courses = SortedDictionary(move(codes));
+
+        vector<pair<uint32_t, uint64_t>> coded; // (course code, packed row)
+        coded.reserve(enrollment.size());
+        for (const auto& r : enrollment)
+            coded.emplace_back(courses.find(r.course_code), uint64_t(students.find(r.student_id)) << 8 | quantize(r.grade));
+        sort(coded.begin(), coded.end());
+
+        rows = BitPackedArray(bits_for(students.size()) + 8);
+        course_start.assign(courses.size() + 1, 0);
+        for (const auto& c : coded) {
+            course_start[c.first + 1]++;
+            rows.push_back(c.second);
+        }
+        for (size_t c = 0; c < courses.size(); c++) course_start[c + 1] += course_start[c];
+        rows.shrink_to_fit();
+
+        overall = BitPackedArray(8);
+        vector<uint8_t> by_student(students.size(), NO_GRADE);
+        for (const auto& g : overall_grades) by_student[students.find(g.first)] = quantize(g.second);
+        for (uint8_t q : by_student) overall.push_back(q);
+        overall.shrink_to_fit();
+    }
+
+    const string& name() const { return term; }
+    size_t row_count() const { return rows.size(); }
+
+    Cursor all_rows() const { return Cursor(this, 0, rows.size(), 0, -1); }
+
+    Cursor course_rows(const string& course_code) const {
+        int64_t c = courses.find(course_code);
+        if (c < 0) return Cursor(this, 0, 0, 0, -1);
+        return Cursor(this, course_start[c], course_start[c + 1], c, -1);
+    }
+
+    // Scans the term's rows, decoding only the student bits of each
+    Cursor student_rows(const string& student_id) const {
+        int64_t s = students.find(student_id);
+        return Cursor(this, 0, s < 0 ? 0 : rows.size(), 0, s);
+    }
+
+    float overall_grade(const string& student_id) const {
+        int64_t s = students.find(student_id);
+        if (s < 0 || overall[s] == NO_GRADE)
+            throw GradeException("Grade not found for student " + student_id + " in term " + term);
+        return dequantize(overall[s]);
+    }
+
+    size_t memory_bytes() const {
+        return sizeof(*this) + term.capacity() + students.memory_bytes() + courses.memory_bytes()
+            + course_start.capacity() * sizeof(uint32_t) + rows.memory_bytes() + overall.memory_bytes();
+    }
+};
+
+// === Prerequisites ===
+// Growable bitset over dense course indices
+class CourseSet {
+private:
+    vector<uint64_t> words;
+
+    // Index of the lowest set bit; `word` must be non-zero
+    static size_t lowest_bit(uint64_t word) {
+#if defined(_MSC_VER) && defined(_M_X64)
+        unsigned long index;
+        _BitScanForward64(&index, word);
+        return index;
+#elif defined(__GNUC__) || defined(__clang__)
+        return size_t(__builtin_ctzll(word));
+#else
+        size_t index = 0;
+        while (!(word & 1)) { word >>= 1; index++; }
+        return index;
+#endif
+    }
+
+public:
+    void set(size_t i) {
+        if (i / 64 >= words.size()) words.resize(i / 64 + 1, 0);
+        words[i / 64] |= uint64_t(1) << (i % 64);
+    }
+
+    void reset(size_t i) {
+        if (i / 64 < words.size()) words[i / 64] &= ~(uint64_t(1) << (i % 64));
+    }
+
+    bool test(size_t i) const {
+        return i / 64 < words.size() && (words[i / 64] >> (i % 64)) & 1;
+    }
+
+    CourseSet& operator|=(const CourseSet& o) {
+        if (o.words.size() > words.size()) words.resize(o.words.size(), 0);
+        for (size_t w = 0; w < o.words.size(); w++) words[w] |= o.words[w];
+        return *this;
+    }
+
+    // True when every member of `required` is also in this set
+    bool covers(const CourseSet& required) const {
+        for (size_t w = 0; w < required.words.size(); w++) {
+            uint64_t have = w < words.size() ? words[w] : 0;
+            if (required.words[w] & ~have) return false;
+        }
+        return true;
+    }
+
+    // Members of `required` missing from this set
+    vector<size_t> missing_from(const CourseSet& required) const {
+        vector<size_t> missing;
+        for (size_t w = 0; w < required.words.size(); w++) {
+            uint64_t gap = required.words[w] & ~(w < words.size() ? words[w] : 0);
+            for (; gap; gap &= gap - 1) missing.push_back(w * 64 + lowest_bit(gap));
+        }
+        return missing;
+    }
+};
+
+// Prerequisite DAG over the catalog with its transitive closure kept as one
+// bitset per course, so checking a student is a few word-wide ANDs against
+// their completed set. Adding an edge rejects cycles and updates the closure
+// of the course and of every course that already depends on it.
+class PrerequisiteGraph {
+private:
+    unordered_map<string, uint32_t> index_of;
+    vector<string> codes;
+    vector<vector<uint32_t>> direct; // Declared prerequisites per course
+    vector<CourseSet> closure;       // All transitive prerequisites per course
+
+    uint32_t require_index(const string& code) const {
+        auto it = index_of.find(code);
+        if (it == index_of.end()) throw EnrollmentException("Course with code " + code + " does not exist.");
+        return it->second;
+    }
+
+public:
+    uint32_t add_course(const string& code) {
+        auto inserted = index_of.emplace(code, codes.size());
+        if (inserted.second) {
+            codes.push_back(code);
+            direct.emplace_back();
+            closure.emplace_back();
+        }
+        return inserted.first->second;
+    }
+
+    void add_prerequisite(const string& course_code, const string& prereq_code) {
+        uint32_t c = require_index(course_code), p = require_index(prereq_code);
+        if (c == p || closure[p].test(c))
+            throw EnrollmentException("Prerequisite " + prereq_code + " for " + course_code + " would create a cycle.");
+        if (find(direct[c].begin(), direct[c].end(), p) != direct[c].end()) return;
+        direct[c].push_back(p);
+
+        CourseSet added = closure[p];
+        added.set(p);
+        closure[c] |= added;
+        added = closure[c];
+        for (size_t d = 0; d < closure.size(); d++)
+            if (closure[d].test(c)) closure[d] |= added;
+    }
+
+    const vector<string>& course_codes() const { return codes; }
+
+    vector<string> direct_prerequisites(const string& course_code) const {
+        vector<string> result;
+        for (uint32_t p : direct[require_index(course_code)]) result.push_back(codes[p]);
+        return result;
+    }
+
+    // Throws listing every missing prerequisite, direct or indirect
+    void check(const string& course_code, const CourseSet& completed, const string& student_id) const {
+        const CourseSet& required = closure[require_index(course_code)];
+        if (completed.covers(required)) return;
+        string missing;
+        for (size_t i : completed.missing_from(required)) missing += (missing.empty() ? "" : ", ") + codes[i];
+        throw EnrollmentException("Student " + student_id + " has not completed prerequisites for " + course_code + ": " + missing);
+    }
+
+    uint32_t index(const string& code) const { return require_index(code); }
+};
+
+// === Exam Scheduling ===
+struct ExamSchedule {
+    vector<string> codes;
+    vector<uint32_t> slot; // Exam slot per course, from 0
+    uint32_t slots = 0;
+
+    void print(ostream& os = cout) const {
+        os << "\n--- Exam Schedule ---\n";
+        if (codes.empty()) os << "No enrollments available.\n";
+        vector<vector<string>> by_slot(slots);
+        for (size_t i = 0; i < codes.size(); i++) by_slot[slot[i]].push_back(codes[i]);
+        for (uint32_t s = 0; s < slots; s++) {
+            os << "Exam slot " << s + 1 << ": ";
+            for (const auto& code : by_slot[s]) os << code << " ";
+            os << endl;
+        }
+    }
+};
+
+// Jones-Plassmann colouring with largest-degree-first priorities. Each round
+// colours, in parallel, every uncoloured course that outranks all of its
+// uncoloured neighbours, so neighbours never pick a colour in the same round.
+// Ties break on a hash of the index, which keeps the result deterministic.
+class ExamScheduler {
+private:
+    static constexpr uint32_t UNCOLOURED = UINT32_MAX;
+
+public:
+    static ExamSchedule schedule(vector<string> codes, const vector<vector<uint32_t>>& adjacent) {
+        size_t n = codes.size();
+        auto priority = [&](uint32_t v) {
+            uint64_t h = v * 0x9E3779B97F4A7C15ull;
+            return make_pair(adjacent[v].size(), (h ^ (h >> 29)) * 0xBF58476D1CE4E5B9ull);
+        };
+        vector<uint32_t> colour(n, UNCOLOURED), chosen(n, UNCOLOURED);
+        vector<uint32_t> remaining(n);
+        for (uint32_t v = 0; v < n; v++) remaining[v] = v;
+
+        WorkerPool& pool = WorkerPool::shared();
+        size_t chunk_count = pool.size() * 4;
+        while (!remaining.empty()) {
+            size_t chunk = (remaining.size() + chunk_count - 1) / chunk_count;
+            pool.run(chunk_count, [&](size_t c) {
+                vector<bool> used;
+                for (size_t k = c * chunk; k < min(remaining.size(), (c + 1) * chunk); k++) {
+                    uint32_t v = remaining[k];
+                    auto mine = make_pair(priority(v), v);
+                    bool local_max = true;
+                    used.assign(adjacent[v].size() + 1, false);
+                    for (uint32_t u : adjacent[v]) {
+                        if (colour[u] == UNCOLOURED) {
+                            if (make_pair(priority(u), u) > mine) {
+                                local_max = false;
+                                break;
+                            }
+                        }
+                        else if (colour[u] < used.size()) {
+                            used[colour[u]] = true;
+                        }
+                    }
+                    if (!local_max) continue;
+                    uint32_t first_free = 0;
+                    while (used[first_free]) first_free++;
+                    chosen[v] = first_free;
+                }
+            });
+            size_t kept = 0;
+            for (uint32_t v : remaining) {
+                if (chosen[v] == UNCOLOURED) remaining[kept++] = v;
+                else colour[v] = chosen[v];
+            }
+            remaining.resize(kept);
+        }
+
+        ExamSchedule result;
+        result.codes = move(codes);
+        result.slot = move(colour);
+        for (uint32_t c : result.slot) result.slots = max(result.slots, c + 1);
+        return result;
+    }
+};
+
+// === Name Search ===
+// Trigram inverted index over person names and course titles. Each word is
+// padded as "  word " so word starts get their own trigrams; the last query
+// word is left open at the end, so it also matches as a prefix. Postings are
+// doc-ID sorted because docs are only appended.
+enum class SearchKind : uint8_t { Student, Professor, Course };
+
+struct SearchHit {
+    SearchKind kind;
+    string id, name;
+    float score;
+
+    void print(ostream& os) const {
+        static const char* kinds[] = { "Student", "Professor", "Course" };
+        os << kinds[int(kind)] << " " << id << ": " << name << " (score " << fixed << setprecision(2) << score << ")\n";
+    }
+};
+
+class NameSearchIndex {
+private:
+    struct Doc {
+        SearchKind kind;
+        string id, name;
+        uint16_t trigram_count;
+    };
+
+    vector<Doc> docs;
+    unordered_map<uint32_t, vector<uint32_t>> postings; // Trigram -> doc IDs
+
+    static vector<string> words_of(const string& text) {
+        vector<string> words(1);
+        for (unsigned char ch : text) {
+            if (isalnum(ch)) words.back() += char(tolower(ch));
+            else if (!words.back().empty()) words.emplace_back();
+        }
+        if (words.back().empty()) words.pop_back();
+        return words;
+    }
+
+    // Distinct trigrams; the last word gets no end padding when open_end is set
+    static vector<uint32_t> trigrams(const string& text, bool open_end) {
+        vector<uint32_t> grams;
+        vector<string> words = words_of(text);
+        for (size_t w = 0; w < words.size(); w++) {
+            string padded = "  " + words[w] + (open_end && w + 1 == words.size() ? "" : " ");
+            for (size_t i = 0; i + 3 <= padded.size(); i++)
+                grams.push_back(uint32_t((unsigned char)padded[i]) << 16 | uint32_t((unsigned char)padded[i + 1]) << 8 | (unsigned char)padded[i + 2]);
+        }
+        sort(grams.begin(), grams.end());
+        grams.erase(unique(grams.begin(), grams.end()), grams.end());
+        return grams;
+    }
+
+public:
+    void add(SearchKind kind, const string& id, const string& name) {
+        vector<uint32_t> grams = trigrams(name, false);
+        uint32_t doc = docs.size();
+        docs.push_back({ kind, id, name, uint16_t(min<size_t>(grams.size(), UINT16_MAX)) });
+        for (uint32_t g : grams) postings[g].push_back(doc);
+    }
+
+    // Ranked fuzzy/prefix search. A doc must share at least half of the query
+    // trigrams; by pigeonhole it then appears in one of the shortest
+    // Q - T + 1 posting lists, so only those are scanned for candidates and
+    // the rest are probed by binary search. Score is the Jaccard similarity
+    // of the trigram sets; the best k hits are kept with a partial sort.
+    vector<SearchHit> search(const string& query, size_t k = 10) const {
+        vector<uint32_t> grams = trigrams(query, true);
+        if (grams.empty() || k == 0) return {};
+        vector<const vector<uint32_t>*> lists;
+        for (uint32_t g : grams) {
+            auto it = postings.find(g);
+            if (it != postings.end()) lists.push_back(&it->second);
+        }
+        size_t q = grams.size(), needed = (q + 1) / 2;
+        if (lists.size() < needed) return {};
+        sort(lists.begin(), lists.end(), [](auto* a, auto* b) { return a->size() < b->size(); });
+
+        size_t scan = lists.size() - needed + 1;
+        vector<uint32_t> candidates;
+        for (size_t i = 0; i < scan; i++) {
+            size_t mid = candidates.size();
+            candidates.insert(candidates.end(), lists[i]->begin(), lists[i]->end());
+            inplace_merge(candidates.begin(), candidates.begin() + mid, candidates.end());
+        }
+
+        vector<pair<float, uint32_t>> scored;
+        for (size_t i = 0; i < candidates.size();) {
+            uint32_t doc = candidates[i];
+            size_t shared = 0;
+            while (i < candidates.size() && candidates[i] == doc) { shared++; i++; }
+            for (size_t l = scan; l < lists.size(); l++)
+                shared += binary_search(lists[l]->begin(), lists[l]->end(), doc);
+            if (shared < needed) continue;
+            float score = float(shared) / (q + docs[doc].trigram_count - shared);
+            scored.emplace_back(score, doc);
+        }
+        k = min(k, scored.size());
+        partial_sort(scored.begin(), scored.begin() + k, scored.end(), [](const auto& a, const auto& b) {
+            return a.first != b.first ? a.first > b.first : a.second < b.second;
+        });
+
+        vector<SearchHit> hits;
+        for (size_t i = 0; i < k; i++) {
+            const Doc& d = docs[scored[i].second];
+            hits.push_back({ d.kind, d.id, d.name, scored[i].first });
+        }
+        return hits;
+    }
+
+    size_t size() const { return docs.size(); }
+};
+
+struct IntegrityReport {
+    size_t shards_walked = 0;
+    vector<string> violations;
+
+    bool ok() const { return violations.empty(); }
+};
+
+class UniversitySystem {
+private:
+    vector<student*> students;
+    GradeBook gradebook;
+    EnrollmentManager enrollment_mgr;
+    Transcript transcript;
+    unordered_map<string, student*> student_index;
+    // Current course and professor records, shared with published versions
+    // and never modified once added (see edit_course)
+    unordered_map<string, shared_ptr<const course>> course_index;
+    unordered_map<string, shared_ptr<const professor>> professor_index;
+    ChangeFeed feed;
+
+    // Student-side counterpart of the EnrollmentManager digest, written by
+    // the student objects themselves as their course lists change
+    ShardedDigest student_course_digest;
+
+    PrerequisiteGraph prerequisites;
+    unordered_map<string, CourseSet> completed_courses; // A course counts once passed
+    unordered_map<string, CourseSet> prior_completions; // Passed in archived terms or marked completed directly
+    static constexpr float PASS_MARK = 60;
+    unordered_map<string, uint64_t> schedules; // Union of meeting slots per enrolled student
+
+    string current_term = "Term 1";
+    vector<shared_ptr<const TermArchive>> archives; // Closed terms, oldest first
+
+    // Seat holds run on whole seconds of this clock; tests can replace it
+    function<uint64_t()> clock_seconds = [] {
+        return uint64_t(chrono::duration_cast<chrono::seconds>(chrono::steady_clock::now().time_since_epoch()).count());
+    };
+    SeatHoldBook seat_holds = SeatHoldBook(clock_seconds());
+
+    NameSearchIndex search_index;
+    vector<vector<const student*>> shard_students = vector<vector<const student*>>(ShardedDigest::SHARDS);
+
+    // Writers serialize on write_mutex and publish a new version after each
+    // commit; readers take snapshots without locking.
+    mutable mutex write_mutex;
+    AppendLog<const student*> student_log;
+    AppendLog<string> course_log;
+    shared_ptr<const SystemVersion> current_version = make_shared<const SystemVersion>();
+
+    template <typename Change>
+    void publish(Change change) {
+        auto next = make_shared<SystemVersion>(*current_version);
+        change(*next);
+        next->version++;
+        atomic_store(&current_version, shared_ptr<const SystemVersion>(move(next)));
+    }
+
+    // Fixed-width hex, so string order matches enrollment order
+    static string roster_key(uint64_t sequence) {
+        char key[17];
+        snprintf(key, sizeof(key), "%016llx", (unsigned long long)sequence);
+        return key;
+    }
+
+    static void roster_add(SystemVersion& v, const string& course_code, uint64_t sequence, const string& student_id) {
+        const auto* roster = v.rosters.find(course_code);
+        v.rosters = v.rosters.set(course_code, (roster ? *roster : PersistentMap<string>()).set(roster_key(sequence), student_id));
+    }
+
+    static void roster_remove(SystemVersion& v, const string& course_code, uint64_t sequence) {
+        const auto* roster = v.rosters.find(course_code);
+        if (roster) v.rosters = v.rosters.set(course_code, roster->erase(roster_key(sequence)));
+    }
+
+    // A course stays completed if it was passed in an earlier term
+    void set_completion(const string& student_id, const string& course_code, bool passed) {
+        uint32_t course = prerequisites.index(course_code);
+        if (passed || prior_completions[student_id].test(course)) completed_courses[student_id].set(course);
+        else completed_courses[student_id].reset(course);
+    }
+
+    // Meeting slots of every course the student is enrolled in, except skip_code
+    uint64_t schedule_of(const string& student_id, const string& skip_code = "") const {
+        uint64_t busy = 0;
+        for (const auto& code : enrollment_mgr.get_student_courses(student_id))
+            if (code != skip_code) busy |= course_index.at(code)->get_meeting_slots();
+        return busy;
+    }
+
+    // Meeting slots of every course the student holds a seat in, except skip_code
+    uint64_t held_schedule_of(const string& student_id, const string& skip_code = "") const {
+        uint64_t busy = 0;
+        for (const auto& code : seat_holds.held_by(student_id))
+            if (code != skip_code) busy |= course_index.at(code)->get_meeting_slots();
+        return busy;
+    }
+
+    // Only built on the failure path, so the check itself stays a single AND
+    string clash_message(const string& student_id, const string& course_code, uint64_t slots) const {
+        string with;
+        for (const auto& code : enrollment_mgr.get_student_courses(student_id))
+            if (code != course_code && (course_index.at(code)->get_meeting_slots() & slots)) with += (with.empty() ? "" : ", ") + code;
+        for (const auto& code : seat_holds.held_by(student_id))
+            if (code != course_code && (course_index.at(code)->get_meeting_slots() & slots)) with += (with.empty() ? "" : ", ") + code + " (held)";
+        return "Course " + course_code + " (" + TimeSlots::describe(slots) + ") clashes with " + with + " for student " + student_id;
+    }
+
+    // Validates the whole batch first, then applies each row in O(1) and
+    // publishes the batch as one version. Expects write_mutex to be held.
+    void apply_course_grades(const vector<CourseGradeRow>& rows) {
+        for (const auto& row : rows) {
+            auto s = student_index.find(row.student_id);
+            if (s == student_index.end())
+                throw GradeException("Student with ID: " + row.student_id + " does not exist.");
+            if (!course_index.count(row.course_code))
+                throw GradeException("Course with code " + row.course_code + " does not exist.");
+            if (!enrollment_mgr.is_enrolled(row.course_code, row.student_id))
+                throw GradeException("Student " + row.student_id + " is not enrolled in course " + row.course_code);
+            Transcript::validate(row.grade);
+        }
+
+        vector<const student*> changed;
+        changed.reserve(rows.size());
+        for (const auto& row : rows) {
+            student* s = student_index[row.student_id];
+            float gpa = transcript.set_grade(row.student_id, row.course_code,
+                course_index[row.course_code]->get_credits(), row.grade);
+            enrollment_mgr.set_grade(row.course_code, row.student_id, row.grade);
+            set_completion(row.student_id, row.course_code, row.grade >= PASS_MARK);
+            s->set_gpa(gpa);
+            changed.push_back(s);
+        }
+        publish([&](SystemVersion& v) {
+            for (const auto* s : changed) v.gpas = v.gpas.set(s->get_id(), s->get_gpa());
+            for (const auto& row : rows) {
+                const auto* grades = v.course_grades.find(row.student_id);
+                v.course_grades = v.course_grades.set(row.student_id,
+                    (grades ? *grades : PersistentMap<float>()).set(row.course_code, row.grade));
+            }
+        });
+        for (const auto& row : rows) feed.append(ChangeType::CourseGradeSet, row.student_id, row.course_code, row.grade);
+    }
+
+public:
+    ~UniversitySystem() {
+        for (auto s : students) delete s;
+        students.clear();
+    }
+
+    void add_student(student* s) {
+         lock_guard<mutex> lock(write_mutex);
+         if (s == nullptr) {
+            throw UniversitySystemException("Cannot add null student.");
+         }
+        if (student_index.count(s->get_id())) {
+            throw UniversitySystemException("Student with ID " + s->get_id() + " already exists.");
+        }
+        students.push_back(s);
+        student_index[s->get_id()] = s;
+        search_index.add(SearchKind::Student, s->get_id(), s->get_name());
+        shard_students[ShardedDigest::shard_of(s->get_id())].push_back(s);
+        s->attach_course_ledger(&student_course_digest);
+        const auto& view = student_log.push_back(s);
+        publish([&](SystemVersion& v) {
+            v.students = view;
+            v.gpas = v.gpas.set(s->get_id(), s->get_gpa());
+        });
+        feed.append(ChangeType::StudentAdded, s->get_id());
+    }
+    void add_professor(professor* p) {
+        lock_guard<mutex> lock(write_mutex);
+        if (p == nullptr) {
+            throw UniversitySystemException("Cannot add null professor.");
+        }
+        if (professor_index.count(p->get_id())) {
+            throw UniversitySystemException("Professor with ID " + p->get_id() + " already exists.");
+        }
+        shared_ptr<const professor> record(p);
+        professor_index[p->get_id()] = record;
+        search_index.add(SearchKind::Professor, p->get_id(), p->get_name());
+        publish([&](SystemVersion& v) { v.professors = v.professors.set(record->get_id(), record); });
+        feed.append(ChangeType::ProfessorAdded, p->get_id());
+    }
+    void add_course(course* c) {
+        lock_guard<mutex> lock(write_mutex);
+        if (c == nullptr) {
+            throw UniversitySystemException("Cannot add null course.");
+        }
+        if (course_index.count(c->get_code())) {
+            throw UniversitySystemException("Course with code " + c->get_code() + " already exists.");
+        }
+        if (!c->get_instructor_id().empty() && !professor_index.count(c->get_instructor_id())) {
+            throw UniversitySystemException("Professor with ID " + c->get_instructor_id() + " does not exist.");
+        }
+        shared_ptr<const course> record(c);
+        course_index[c->get_code()] = record;
+        prerequisites.add_course(c->get_code());
+        search_index.add(SearchKind::Course, c->get_code(), c->get_title());
+        const auto& view = course_log.push_back(c->get_code());
+        publish([&](SystemVersion& v) {
+            v.course_codes = view;
+            v.courses = v.courses.set(record->get_code(), record);
+        });
+        feed.append(ChangeType::CourseAdded, c->get_code());
+    }
+
+private:
+    // Holds are expired lazily, before anything that counts seats
+    void expire_holds() {
+        seat_holds.expire_until(clock_seconds(), [&](const SeatHoldBook::Hold& h) {
+            enrollment_mgr.release_seat(h.course_code);
+            feed.append(ChangeType::HoldLapsed, h.student_id, h.course_code);
+        });
+    }
+
+    // Records are shared with published versions, so an edit is applied to a
+    // copy that then replaces the record in the index and in a new version
+    template <typename Edit>
+    void edit_course(const string& course_code, Edit edit) {
+        auto& record = course_index.at(course_code);
+        auto edited = make_shared<course>(*record);
+        edit(*edited);
+        record = edited;
+        publish([&](SystemVersion& v) { v.courses = v.courses.set(course_code, record); });
+    }
+
+    template <typename Edit>
+    void edit_professor(const string& professor_id, Edit edit) {
+        auto& record = professor_index.at(professor_id);
+        auto edited = make_shared<professor>(*record);
+        edit(*edited);
+        record = edited;
+        publish([&](SystemVersion& v) { v.professors = v.professors.set(professor_id, record); });
+    }
+
+    // Checks for holding a new seat; open holds count toward the course limit
+    // and the student's timetable just like enrolled courses
+    void check_can_join(const string& course_code, const string& student_id) {
+        if (!course_index.count(course_code))
+            throw EnrollmentException("Course with code " + course_code + " does not exist.");
+        if (!student_index.count(student_id))
+            throw EnrollmentException("Student with ID " + student_id + " does not exist.");
+        if (enrollment_mgr.is_enrolled(course_code, student_id))
+            throw EnrollmentException("Student " + student_id + " is already enrolled in course " + course_code);
+        if (student_index[student_id]->course_count() + seat_holds.held_by(student_id).size() >= student::MAX_COURSES)
+            throw EnrollmentException("Course limit reached for student: " + student_id);
+        prerequisites.check(course_code, completed_courses[student_id], student_id);
+        uint64_t slots = course_index[course_code]->get_meeting_slots();
+        if ((schedules[student_id] | held_schedule_of(student_id)) & slots)
+            throw EnrollmentException(clash_message(student_id, course_code, slots));
+    }
+
+public:
+    // Reserves a seat for `minutes`; it counts against capacity until it is
+    // confirmed, released or lapses
+    void hold_seat(const string& course_code, const string& student_id, unsigned minutes) {
+        lock_guard<mutex> lock(write_mutex);
+        if (minutes == 0) throw EnrollmentException("Seat hold must last at least a minute.");
+        expire_holds();
+        if (seat_holds.find(student_id, course_code))
+            throw EnrollmentException("Student " + student_id + " already holds a seat in course " + course_code);
+        check_can_join(course_code, student_id);
+        enrollment_mgr.hold_seat(course_code);
+        seat_holds.place(student_id, course_code, clock_seconds() + uint64_t(minutes) * 60);
+        feed.append(ChangeType::SeatHeld, student_id, course_code);
+    }
+
+    // Enrolls using the held seat; throws if the hold has lapsed
+    void confirm_hold(const string& course_code, const string& student_id) {
+        lock_guard<mutex> lock(write_mutex);
+        enroll_locked(course_code, student_id, true);
+    }
+
+    void release_hold(const string& course_code, const string& student_id) {
+        lock_guard<mutex> lock(write_mutex);
+        if (!seat_holds.release(student_id, course_code))
+            throw EnrollmentException("Student " + student_id + " holds no seat in course " + course_code);
+        enrollment_mgr.release_seat(course_code);
+        feed.append(ChangeType::HoldReleased, student_id, course_code);
+    }
+
+    size_t active_holds() {
+        lock_guard<mutex> lock(write_mutex);
+        expire_holds();
+        return seat_holds.size();
+    }
+
+    // Only while no holds are pending, since the timer wheel restarts on the new clock
+    void set_clock(function<uint64_t()> seconds) {
+        lock_guard<mutex> lock(write_mutex);
+        if (seat_holds.size()) throw EnrollmentException("Cannot change the clock while seat holds are pending.");
+        clock_seconds = move(seconds);
+        seat_holds = SeatHoldBook(clock_seconds());
+    }
+
+    // Takes the student's own hold on the course if there is one
+    void enroll_student(const string& course_code, const string& student_id) {
+        lock_guard<mutex> lock(write_mutex);
+        enroll_locked(course_code, student_id, false);
+    }
+
+private:
+    void enroll_locked(const string& course_code, const string& student_id, bool require_hold) {
+        expire_holds();
+        bool from_hold = seat_holds.find(student_id, course_code) != nullptr;
+        if (require_hold && !from_hold)
+            throw EnrollmentException("Student " + student_id + " holds no seat in course " + course_code);
+        // Check if the course exists
+        if (!course_index.count(course_code)) {
+            throw EnrollmentException("Course with code " + course_code + " does not exist.");
+        }
+
+        // Check if the student exists
+        auto found = student_index.find(student_id);
+        if (found == student_index.end()) {
+            throw EnrollmentException("Student with ID " + student_id + " does not exist.");
+        }
+        prerequisites.check(course_code, completed_courses[student_id], student_id);
+        // Seats held in other courses are spoken for, so they count like enrollments
+        uint64_t slots = course_index[course_code]->get_meeting_slots();
+        uint64_t& busy = schedules[student_id];
+        bool enrolled = enrollment_mgr.is_enrolled(course_code, student_id); // Re-enrolling reports the duplicate instead
+        size_t other_holds = seat_holds.held_by(student_id).size() - (from_hold ? 1 : 0);
+        if (!enrolled && found->second->course_count() + other_holds >= student::MAX_COURSES)
+            throw EnrollmentException("Course limit reached for student: " + student_id);
+        if (((busy | held_schedule_of(student_id, course_code)) & slots) && !enrolled)
+            throw EnrollmentException(clash_message(student_id, course_code, slots));
+
+        // Student side checks the course limit; undo it if the roster refuses
+        found->second->enroll_course(course_code);
+        uint64_t sequence;
+        try {
+            sequence = enrollment_mgr.enroll(course_code, student_id, from_hold);
+        }
+        catch (const UniversitySystemException&) {
+            found->second->drop_course(course_code);
+            throw;
+        }
+        busy |= slots;
+        if (from_hold) seat_holds.release(student_id, course_code);
+        publish([&](SystemVersion& v) { roster_add(v, course_code, sequence, student_id); });
+        feed.append(ChangeType::Enrolled, student_id, course_code);
+    }
+
+public:
+    void drop_student(const string& course_code, const string& student_id) {
+        lock_guard<mutex> lock(write_mutex);
+        auto found = student_index.find(student_id);
+        if (found == student_index.end()) {
+            throw EnrollmentException("Student with ID " + student_id + " does not exist.");
+        }
+        uint64_t sequence = enrollment_mgr.drop(course_code, student_id);
+        found->second->drop_course(course_code);
+        schedules[student_id] = schedule_of(student_id);
+
+        // A dropped course's grade no longer counts towards GPA or completion
+        bool regraded = transcript.remove_grade(student_id, course_code);
+        if (regraded) {
+            student* s = found->second;
+            float gpa = transcript.has_grades(student_id) ? transcript.gpa(student_id) : s->get_entry_gpa();
+            s->set_gpa(gpa);
+            set_completion(student_id, course_code, false);
+        }
+        publish([&](SystemVersion& v) {
+            roster_remove(v, course_code, sequence);
+            if (!regraded) return;
+            v.gpas = v.gpas.set(student_id, found->second->get_gpa());
+            auto grades = v.course_grades.find(student_id)->erase(course_code);
+            v.course_grades = grades.empty() ? v.course_grades.erase(student_id) : v.course_grades.set(student_id, grades);
+        });
+        feed.append(ChangeType::Dropped, student_id, course_code);
+    }
+
+    void assign_grade(const string& student_id, float grade) {
+        lock_guard<mutex> lock(write_mutex);
+        // Check if the student exists before assigning a grade.
+        if (!student_index.count(student_id)) {
+             throw GradeException("Student with ID: " + student_id + " does not exist.");
+        }
+        gradebook.add_grade(student_id, grade);
+        publish([&](SystemVersion& v) { v.grades = v.grades.set(student_id, grade); });
+        feed.append(ChangeType::GradeSet, student_id, "", grade);
+    }
+
+    // Records a grade for one course the student is enrolled in and updates
+    // their credit-weighted GPA
+    void assign_course_grade(const string& student_id, const string& course_code, float grade) {
+        upload_course_grades({ { student_id, course_code, grade } });
+    }
+
+    // Applies a batch of course grades, e.g. an end-of-term upload
+    void upload_course_grades(const vector<CourseGradeRow>& rows) {
+        lock_guard<mutex> lock(write_mutex);
+        apply_course_grades(rows);
+    }
+
+    // Shifts every graded row in the course and carries the new grades into
+    // the transcript and GPAs
+    void curve_course(const string& course_code, float points) {
+        lock_guard<mutex> lock(write_mutex);
+        apply_course_grades(enrollment_mgr.curved_grades(course_code, points));
+    }
+
+    SectionStats course_statistics(const string& course_code, float pass_mark = 60) const {
+        lock_guard<mutex> lock(write_mutex);
+        return enrollment_mgr.section_stats(course_code, pass_mark);
+    }
+
+    void report_course_statistics(ostream& os = cout) const {
+        vector<pair<string, SectionStats>> all;
+        {
+            lock_guard<mutex> lock(write_mutex);
+            all = enrollment_mgr.all_section_stats();
+        }
+        os << "\n--- Course Statistics ---\n";
+        if (all.empty()) os << "No enrollments available.\n";
+        for (const auto& entry : all) entry.second.print(os, entry.first);
+    }
+
+    // Fewest exam slots found such that no student sits two exams at once
+    ExamSchedule schedule_exams() const {
+        vector<string> codes;
+        vector<vector<uint32_t>> adjacent;
+        {
+            lock_guard<mutex> lock(write_mutex);
+            adjacent = enrollment_mgr.conflict_graph(codes);
+        }
+        return ExamScheduler::schedule(move(codes), adjacent);
+    }
+
+    void report_exam_schedule(ostream& os = cout) const { schedule_exams().print(os); }
+
+    float get_course_grade(const string& student_id, const string& course_code) const {
+        lock_guard<mutex> lock(write_mutex);
+        return transcript.get_grade(student_id, course_code);
+    }
+
+    float student_gpa(const string& student_id) const {
+        const float* gpa = snapshot().data().gpas.find(student_id);
+        if (!gpa) throw UniversitySystemException("Student with ID " + student_id + " does not exist.");
+        return *gpa;
+    }
+
+    void set_course_instructor(const string& course_code, const string& professor_id) {
+        lock_guard<mutex> lock(write_mutex);
+        if (!course_index.count(course_code)) throw UniversitySystemException("Course with code " + course_code + " does not exist.");
+        if (!professor_index.count(professor_id)) throw UniversitySystemException("Professor with ID " + professor_id + " does not exist.");
+        edit_course(course_code, [&](course& c) { c.set_instructor(professor_id); });
+        feed.append(ChangeType::CourseUpdated, course_code);
+    }
+
+    // Rejected if the new times would clash for any student already enrolled
+    void set_course_meeting_slots(const string& course_code, uint64_t slots) {
+        lock_guard<mutex> lock(write_mutex);
+        auto c = course_index.find(course_code);
+        if (c == course_index.end()) throw UniversitySystemException("Course with code " + course_code + " does not exist.");
+        vector<string> roster = enrollment_mgr.get_enrolled_students(course_code);
+        for (const auto& id : roster)
+            if (schedule_of(id, course_code) & slots) throw EnrollmentException(clash_message(id, course_code, slots));
+        edit_course(course_code, [&](course& edited) { edited.set_meeting_slots(slots); });
+        for (const auto& id : roster) schedules[id] = schedule_of(id);
+        feed.append(ChangeType::CourseUpdated, course_code);
+    }
+
+    void update_professor_salary(const string& professor_id, double salary) {
+        lock_guard<mutex> lock(write_mutex);
+        if (!professor_index.count(professor_id)) throw UniversitySystemException("Professor with ID " + professor_id + " does not exist.");
+        edit_professor(professor_id, [&](professor& edited) { edited.set_salary(salary); });
+        feed.append(ChangeType::ProfessorUpdated, professor_id);
+    }
+
+    // Finds students, professors and courses by partial or misspelled name
+    vector<SearchHit> search_by_name(const string& query, size_t k = 10) const {
+        lock_guard<mutex> lock(write_mutex);
+        return search_index.search(query, k);
+    }
+
+    void add_prerequisite(const string& course_code, const string& prereq_code) {
+        lock_guard<mutex> lock(write_mutex);
+        prerequisites.add_prerequisite(course_code, prereq_code);
+        feed.append(ChangeType::CourseUpdated, course_code);
+    }
+
+    // Credits a course passed elsewhere, e.g. transfer credit
+    void mark_course_completed(const string& student_id, const string& course_code) {
+        lock_guard<mutex> lock(write_mutex);
+        if (!student_index.count(student_id))
+            throw EnrollmentException("Student with ID " + student_id + " does not exist.");
+        completed_courses[student_id].set(prerequisites.index(course_code));
+        prior_completions[student_id].set(prerequisites.index(course_code));
+    }
+
+    // Checks that rosters agree with each student's course list and that
+    // every grade belongs to a registered student. The quick path compares
+    // the roster digest with the one the student objects keep, and the grade
+    // book digest with one rebuilt from the registry, then walks only the
+    // shards that differ. Full mode walks every shard and also recomputes
+    // the student-side course digest. Shards are checked in parallel.
+    IntegrityReport verify_integrity(bool full = false) const {
+        lock_guard<mutex> lock(write_mutex);
+        const ShardedDigest& roster = enrollment_mgr.get_digest();
+        const ShardedDigest& graded = gradebook.get_digest();
+        ShardedDigest registered_graded; // Each task writes only its own shard
+        WorkerPool::shared().run(ShardedDigest::SHARDS, [&](size_t sh) {
+            for (const auto* s : shard_students[sh])
+                if (gradebook.has_grade(s->get_id())) registered_graded.add(s->get_id());
+        });
+        IntegrityReport report;
+        if (!full && roster.root() == student_course_digest.root() && graded.root() == registered_graded.root())
+            return report;
+
+        vector<bool> selected(ShardedDigest::SHARDS, full);
+        vector<size_t> shards;
+        for (size_t i = 0; i < ShardedDigest::SHARDS; i++) {
+            if (!full && roster.shard(i) == student_course_digest.shard(i) && graded.shard(i) == registered_graded.shard(i))
+                continue;
+            selected[i] = true;
+            shards.push_back(i);
+        }
+        report.shards_walked = shards.size();
+
+        // One task per selected shard, plus two for IDs the student registry lacks
+        vector<vector<string>> found(shards.size() + 2);
+        WorkerPool::shared().run(found.size(), [&](size_t task) {
+            auto& out = found[task];
+            if (task == shards.size()) {
+                for (const auto& id : enrollment_mgr.student_ids_in(selected))
+                    if (!student_index.count(id)) out.push_back("Roster lists unknown student " + id);
+                return;
+            }
+            if (task == shards.size() + 1) {
+                for (const auto& id : gradebook.student_ids_in(selected))
+                    if (!student_index.count(id)) out.push_back("Grade recorded for unknown student " + id);
+                return;
+            }
+            ShardedDigest recomputed;
+            for (const auto* s : shard_students[shards[task]]) {
+                vector<string> own = s->get_courses(), listed = enrollment_mgr.get_student_courses(s->get_id());
+                sort(own.begin(), own.end());
+                sort(listed.begin(), listed.end());
+                for (const auto& code : own) recomputed.add(s->get_id(), code);
+                if (own != listed)
+                    out.push_back("Student " + s->get_id() + " course list does not match course rosters");
+            }
+            size_t sh = shards[task];
+            if (recomputed.shard(sh) != student_course_digest.shard(sh))
+                out.push_back("Checksum mismatch in shard " + to_string(sh) + " of the student course lists");
+        });
+        for (auto& v : found) report.violations.insert(report.violations.end(), v.begin(), v.end());
+        return report;
+    }
+
+    void report_integrity(bool full = false) const {
+        IntegrityReport report = verify_integrity(full);
+        cout << "Integrity: " << (report.ok() ? "OK" : "FAILED") << " (" << report.shards_walked << " of "
+            << ShardedDigest::SHARDS << " shards walked)\n";
+        for (const auto& v : report.violations) cout << "  " << v << endl;
+    }
+
+    // Writes a consistent columnar copy of the current state without blocking writers
+    void export_columnar(const string& path, size_t batch_rows = 65536, bool compress = false) const {
+        ::export_columnar(snapshot(), path, batch_rows, compress);
+    }
+
+    // Enrollment, grade and entity changes in commit order
+    ChangeFeed& change_feed() { return feed; }
+
+    Snapshot snapshot() const {
+        return Snapshot(atomic_load(&current_version));
+    }
+
+    void report_all_students() const {
+        snapshot().report_all_students();
+    }
+
+    void report_all_courses() const {
+        snapshot().report_all_courses();
+    }
+
+    void report_grades() const {
+        snapshot().report_grades();
+    }
+
+    // Freezes this term's enrollments and grades into an archive and starts
+    // the next term with empty rosters, grade book and course lists. GPA
+    // totals and completed courses carry over. Refused while holds are pending.
+    void roll_over_term(const string& next_term) {
+        lock_guard<mutex> lock(write_mutex);
+        if (next_term.empty()) throw UniversitySystemException("Term name cannot be empty.");
+        bool taken = next_term == current_term;
+        for (const auto& a : archives) taken = taken || a->name() == next_term;
+        if (taken)
+            throw UniversitySystemException("Term " + next_term + " already exists.");
+        expire_holds();
+        if (seat_holds.size()) throw EnrollmentException("Cannot roll over the term while seat holds are pending.");
+
+        vector<ArchiveRow> rows;
+        enrollment_mgr.for_each_section([&](const EnrollmentManager::Section& s) {
+            const float* grades = enrollment_mgr.grades(s);
+            for (size_t i = 0; i < s.students.size(); i++) rows.push_back({ s.code, s.students[i], grades[i] });
+        });
+        vector<pair<string, float>> overall;
+        gradebook.for_each_grade([&](const string& id, float grade) { overall.emplace_back(id, grade); });
+        archives.push_back(make_shared<const TermArchive>(current_term, move(rows), overall));
+
+        enrollment_mgr.clear();
+        gradebook.clear();
+        transcript.close_term();
+        prior_completions = completed_courses;
+        for (auto* s : students) s->clear_courses();
+        schedules.clear();
+        string closed_term = current_term;
+        current_term = next_term;
+        publish([](SystemVersion& v) {
+            v.grades = PersistentMap<float>();
+            v.course_grades = PersistentMap<PersistentMap<float>>();
+            v.rosters = PersistentMap<PersistentMap<string>>();
+        });
+        feed.append(ChangeType::TermRolledOver, closed_term);
+    }
+
+    string term() const {
+        lock_guard<mutex> lock(write_mutex);
+        return current_term;
+    }
+
+    // Archives stay valid after later rollovers; read them through their cursors
+    shared_ptr<const TermArchive> archived_term(const string& term_name) const {
+        lock_guard<mutex> lock(write_mutex);
+        for (const auto& a : archives)
+            if (a->name() == term_name) return a;
+        throw UniversitySystemException("No archived term named " + term_name);
+    }
+
+    void report_term_history(const string& student_id, ostream& os = cout) const {
+        vector<shared_ptr<const TermArchive>> terms;
+        {
+            lock_guard<mutex> lock(write_mutex);
+            terms = archives;
+        }
+        os << "\n--- Term History for " << student_id << " ---\n";
+        if (terms.empty()) os << "No archived terms.\n";
+        for (const auto& a : terms) {
+            os << a->name() << ": ";
+            auto cursor = a->student_rows(student_id);
+            bool any = false;
+            while (cursor.next()) {
+                os << cursor.course_code() << " ";
+                if (cursor.graded()) os << fixed << setprecision(1) << cursor.grade() << " ";
+                else os << "(ungraded) ";
+                any = true;
+            }
+            if (!any) os << "not enrolled";
+            os << endl;
+        }
+    }
+
      void display_course_enrollment(const string& courseCode) const {
-        enrollment_mgr.display_enrollment(courseCode);
+        snapshot().display_enrollment(courseCode);
     }
 
     void menu() {
@@ -423,6 +3407,8 @@ public:
                 case 4:
                     cout << "Enter Student ID: ";
                     getline(cin, id);
+                    cout << "Enter Course Code: ";
+                    getline(cin, code);
                     cout << "Enter Grade: ";
                     cin >> grade;
                     if (cin.fail()) {
@@ -431,8 +3417,8 @@ public:
                         throw GradeException("Invalid grade input.  Please enter a number between 0 and 100.");
                     }
                     cin.ignore(numeric_limits<streamsize>::max(), '\n');
-                    assign_grade(id, grade);
-                    cout << "Grade assigned successfully.\n";
+                    assign_course_grade(id, code, grade);
+                    cout << "Grade assigned successfully. GPA: " << fixed << setprecision(2) << student_gpa(id) << endl;
                     break;
                 case 5:
                     report_grades();
@@ -452,13 +3438,416 @@ public:
             catch (const UniversitySystemException& e) {
                 cerr << "Exception: " << e.what() << endl;
             }
+            feed.flush_sink();
         } while (choice != 7);
     }
+
+    // Runs one request of the server protocol: a menu number followed by its
+    // arguments on one line, e.g. "3 CS101 S001" or "4 S001 CS101 91.5". The server
+    // has no exit, so 7 is name search instead: "7 <query>".
+    void handle_request(const string& line, ostream& out) {
+        istringstream in(line);
+        int choice = 0;
+        string id, code;
+        float grade;
+        if (!(in >> choice)) throw UniversitySystemException("Request must start with a menu number.");
+
+        switch (choice) {
+        case 1:
+            snapshot().report_all_students(out);
+            break;
+        case 2:
+            snapshot().report_all_courses(out);
+            break;
+        case 3:
+            if (!(in >> code >> id)) throw EnrollmentException("Usage: 3 <course code> <student id>");
+            enroll_student(code, id);
+            out << "Enrollment successful.\n";
+            break;
+        case 4:
+            if (!(in >> id >> code >> grade)) throw GradeException("Usage: 4 <student id> <course code> <grade>");
+            assign_course_grade(id, code, grade);
+            out << "Grade assigned successfully. GPA: " << fixed << setprecision(2) << student_gpa(id) << endl;
+            break;
+        case 5:
+            snapshot().report_grades(out);
+            break;
+        case 6:
+            if (!(in >> code)) throw EnrollmentException("Usage: 6 <course code>");
+            snapshot().display_enrollment(code, out);
+            break;
+        case 7: {
+            string query;
+            getline(in >> ws, query);
+            if (query.empty()) throw UniversitySystemException("Usage: 7 <name or partial name>");
+            auto hits = search_by_name(query);
+            if (hits.empty()) out << "No matches.\n";
+            for (const auto& hit : hits) hit.print(out);
+            break;
+        }
+        default:
+            throw UniversitySystemException("Unknown request: " + to_string(choice));
+        }
+    }
+};
+
+#ifdef __linux__
+// === Socket Server ===
+// Protocol: each request is one line (see UniversitySystem::handle_request).
+// Each response is a header line "OK <length>" or "ERR <length>" followed by
+// exactly <length> bytes of text. Clients may pipeline any number of requests;
+// responses come back in request order.
+//
+// Addresses are "unix:<path>" or "tcp:<port>" (bound to 127.0.0.1 only).
+
+static int open_socket(const string& address, bool listening) {
+    int fd;
+    if (address.rfind("unix:", 0) == 0) {
+        string path = address.substr(5);
+        sockaddr_un addr{};
+        if (path.empty() || path.size() >= sizeof(addr.sun_path)) throw ServerException("Invalid socket path: " + path);
+        addr.sun_family = AF_UNIX;
+        memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) throw ServerException("socket() failed: " + string(strerror(errno)));
+        if (listening) unlink(path.c_str());
+        int rc = listening ? ::bind(fd, (sockaddr*)&addr, sizeof(addr)) : connect(fd, (sockaddr*)&addr, sizeof(addr));
+        if (rc < 0) {
+            close(fd);
+            throw ServerException("Cannot open " + address + ": " + strerror(errno));
+        }
+    }
+    else if (address.rfind("tcp:", 0) == 0) {
+        int port = atoi(address.c_str() + 4);
+        if (port <= 0 || port > 65535) throw ServerException("Invalid port in address: " + address);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) throw ServerException("socket() failed: " + string(strerror(errno)));
+        int one = 1;
+        if (listening) setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        else setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        int rc = listening ? ::bind(fd, (sockaddr*)&addr, sizeof(addr)) : connect(fd, (sockaddr*)&addr, sizeof(addr));
+        if (rc < 0) {
+            close(fd);
+            throw ServerException("Cannot open " + address + ": " + strerror(errno));
+        }
+    }
+    else {
+        throw ServerException("Address must be unix:<path> or tcp:<port>. Given value was: " + address);
+    }
+    if (listening && listen(fd, SOMAXCONN) < 0) {
+        close(fd);
+        throw ServerException("listen() failed: " + string(strerror(errno)));
+    }
+    return fd;
+}
+
+// Single-threaded epoll loop serving many clients from one UniversitySystem.
+// Reports read from snapshots and use the worker pool, so the loop itself
+// only parses requests and moves bytes.
+class UniversityServer {
+private:
+    static const size_t MAX_REQUEST = 4096;       // Longest accepted request line
+    static const size_t OUTPUT_HIGH_WATER = 1 << 20; // Stop reading requests past this much unsent output
+    static const size_t INPUT_HIGH_WATER = 1 << 20;  // Most buffered input read in one go
+
+    struct Connection {
+        int fd;
+        string in, out;
+        size_t out_pos = 0;
+        bool peer_closed = false;
+        uint32_t events = EPOLLIN | EPOLLRDHUP; // Currently registered with epoll
+    };
+
+    UniversitySystem& system;
+    string address;
+    int listen_fd = -1, epoll_fd = -1, stop_fd = -1;
+    map<int, Connection> connections;
+
+    static void set_nonblocking(int fd) {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    }
+
+    static bool backlogged(const Connection& c) { return c.out.size() - c.out_pos >= OUTPUT_HIGH_WATER; }
+
+    // Input is unwatched while output is backlogged, so further pipelined
+    // requests wait in the socket instead of busy-looping or piling up here
+    void watch(Connection& c) {
+        uint32_t events = (c.out_pos < c.out.size() ? uint32_t(EPOLLOUT) : 0u)
+            | (c.peer_closed || backlogged(c) ? 0u : uint32_t(EPOLLIN | EPOLLRDHUP));
+        if (c.events == events) return;
+        c.events = events;
+        epoll_event ev{};
+        ev.events = events;
+        ev.data.fd = c.fd;
+        epoll_ctl(epoll_fd, EPOLL_CTL_MOD, c.fd, &ev);
+    }
+
+    void respond(Connection& c, bool ok, const string& body) {
+        c.out += (ok ? "OK " : "ERR ") + to_string(body.size()) + "\n";
+        c.out += body;
+    }
+
+    void process_requests(Connection& c) {
+        size_t start = 0, end;
+        while (!backlogged(c) && (end = c.in.find('\n', start)) != string::npos) {
+            string line = c.in.substr(start, end - start);
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            start = end + 1;
+            ostringstream body;
+            try {
+                system.handle_request(line, body);
+                respond(c, true, body.str());
+            }
+            catch (const exception& e) { // Any failure answers this request only
+                respond(c, false, e.what());
+            }
+        }
+        c.in.erase(0, start);
+        // Only the trailing unterminated line counts; complete lines held back by the output limit are not one request
+        if (c.in.size() > MAX_REQUEST && c.in.find('\n') == string::npos) {
+            respond(c, false, "Request too long.");
+            c.in.clear();
+            c.peer_closed = true; // Answer, then hang up
+        }
+    }
+
+    // Returns false once the connection is finished and closed
+    bool flush(Connection& c) {
+        while (c.out_pos < c.out.size()) {
+            ssize_t n = send(c.fd, c.out.data() + c.out_pos, c.out.size() - c.out_pos, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                return close_connection(c);
+            }
+            c.out_pos += n;
+        }
+        if (c.out_pos == c.out.size()) {
+            c.out.clear();
+            c.out_pos = 0;
+            if (c.peer_closed && c.in.find('\n') == string::npos) return close_connection(c);
+        }
+        watch(c);
+        return true;
+    }
+
+    bool close_connection(Connection& c) {
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, c.fd, nullptr);
+        close(c.fd);
+        connections.erase(c.fd);
+        return false;
+    }
+
+    void accept_clients() {
+        while (true) {
+            int fd = accept(listen_fd, nullptr, nullptr);
+            if (fd < 0) return;
+            set_nonblocking(fd);
+            Connection& c = connections[fd];
+            c.fd = fd;
+            epoll_event ev{};
+            ev.events = EPOLLIN | EPOLLRDHUP;
+            ev.data.fd = fd;
+            epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev);
+        }
+    }
+
+    void on_event(Connection& c, uint32_t events) {
+        if ((events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) && !backlogged(c)) {
+            char buf[16384];
+            while (!c.peer_closed && c.in.size() < INPUT_HIGH_WATER) {
+                ssize_t n = recv(c.fd, buf, sizeof(buf), 0);
+                if (n > 0) c.in.append(buf, n);
+                else if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) c.peer_closed = true;
+                else break;
+            }
+        }
+        // Requests held back by the output limit run once the output drains
+        do {
+            process_requests(c);
+            if (!flush(c)) return;
+        } while (!backlogged(c) && c.in.find('\n') != string::npos);
+    }
+
+public:
+    UniversityServer(UniversitySystem& sys, const string& addr) : system(sys), address(addr) {
+        listen_fd = open_socket(address, true);
+        set_nonblocking(listen_fd);
+        epoll_fd = epoll_create1(0);
+        stop_fd = eventfd(0, EFD_NONBLOCK);
+        if (epoll_fd < 0 || stop_fd < 0) throw ServerException("Cannot create event loop: " + string(strerror(errno)));
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = listen_fd;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &ev);
+        ev.data.fd = stop_fd;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, stop_fd, &ev);
+    }
+
+    ~UniversityServer() {
+        for (auto& entry : connections) close(entry.first);
+        if (stop_fd >= 0) close(stop_fd);
+        if (epoll_fd >= 0) close(epoll_fd);
+        if (listen_fd >= 0) close(listen_fd);
+        if (address.rfind("unix:", 0) == 0) unlink(address.c_str() + 5);
+    }
+
+    // Safe to call from any thread; run() returns after the current batch
+    void stop() {
+        uint64_t one = 1;
+        if (write(stop_fd, &one, sizeof(one)) < 0) cerr << "Cannot signal server stop.\n";
+    }
+
+    void run() {
+        epoll_event events[64];
+        while (true) {
+            int n = epoll_wait(epoll_fd, events, 64, -1);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                throw ServerException("epoll_wait() failed: " + string(strerror(errno)));
+            }
+            for (int i = 0; i < n; i++) {
+                int fd = events[i].data.fd;
+                if (fd == stop_fd) return;
+                if (fd == listen_fd) {
+                    accept_clients();
+                    continue;
+                }
+                auto it = connections.find(fd);
+                if (it == connections.end()) continue;
+                try {
+                    on_event(it->second, events[i].events);
+                }
+                catch (const exception& e) { // e.g. out of memory while buffering; only this client is dropped
+                    cerr << "Closing connection after error: " << e.what() << endl;
+                    it = connections.find(fd);
+                    if (it != connections.end()) close_connection(it->second);
+                }
+            }
+            system.change_feed().flush_sink(); // The server only stops by signal, so keep the file current
+        }
+    }
 };
 
-int main() {
+// Blocking client for the server protocol
+class UniversityClient {
+private:
+    int fd;
+    string buffer;
+
+    void fill() {
+        char buf[16384];
+        ssize_t n = recv(fd, buf, sizeof(buf), 0);
+        if (n <= 0) throw ServerException("Connection closed by server.");
+        buffer.append(buf, n);
+    }
+
+public:
+    explicit UniversityClient(const string& address) : fd(open_socket(address, false)) {}
+    ~UniversityClient() { close(fd); }
+    UniversityClient(const UniversityClient&) = delete;
+    UniversityClient& operator=(const UniversityClient&) = delete;
+
+    void send_request(const string& line) {
+        string msg = line + "\n";
+        for (size_t sent = 0; sent < msg.size();) {
+            ssize_t n = send(fd, msg.data() + sent, msg.size() - sent, MSG_NOSIGNAL);
+            if (n < 0) throw ServerException("send() failed: " + string(strerror(errno)));
+            sent += n;
+        }
+    }
+
+    // Returns the body of the next response; sets ok to false for ERR
+    string read_response(bool& ok) {
+        size_t eol;
+        while ((eol = buffer.find('\n')) == string::npos) fill();
+        string header = buffer.substr(0, eol);
+        ok = header.rfind("OK ", 0) == 0;
+        if (!ok && header.rfind("ERR ", 0) != 0) throw ServerException("Malformed response header: " + header);
+        size_t length = stoul(header.substr(ok ? 3 : 4));
+        while (buffer.size() < eol + 1 + length) fill();
+        string body = buffer.substr(eol + 1, length);
+        buffer.erase(0, eol + 1 + length);
+        return body;
+    }
+
+    string request(const string& line) {
+        bool ok;
+        send_request(line);
+        string body = read_response(ok);
+        if (!ok) throw ServerException(body);
+        return body;
+    }
+};
+
+// Load test: each client thread keeps `depth` requests in flight
+void run_load_test(const string& address, int clients, int requests, int depth, const string& line) {
+    if (clients <= 0 || requests <= 0 || depth <= 0)
+        throw ServerException("Clients, requests and pipeline depth must be positive numbers.");
+    atomic<long> errors{ 0 };
+    auto begin = chrono::steady_clock::now();
+    vector<thread> threads;
+    for (int t = 0; t < clients; t++) {
+        threads.emplace_back([&] {
+            try {
+                UniversityClient client(address);
+                int sent = 0, received = 0;
+                bool ok;
+                while (received < requests) {
+                    while (sent < requests && sent - received < depth) {
+                        client.send_request(line);
+                        sent++;
+                    }
+                    client.read_response(ok);
+                    if (!ok) errors++;
+                    received++;
+                }
+            }
+            catch (const exception& e) {
+                cerr << "Client failed: " << e.what() << endl;
+                errors++;
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+    long total = long(clients) * requests;
+    cout << "Requests: " << total << ", Errors: " << errors << ", Time: " << fixed << setprecision(3) << seconds
+        << " s, Throughput: " << setprecision(0) << total / seconds << " req/s" << endl;
+}
+#endif
+
+int main(int argc, char* argv[]) {
     try {
+        // assign4 --feed <file> [mode ...] also appends every change to <file>
+        string feed_path;
+        if (argc > 2 && string(argv[1]) == "--feed") {
+            feed_path = argv[2];
+            argv += 2;
+            argc -= 2;
+        }
+        string mode = argc > 1 ? argv[1] : "";
+
+        // assign4 --replay <file> [from] prints the changes recorded by --feed
+        if (mode == "--replay") {
+            if (argc < 3) throw UniversitySystemException("Usage: --replay <file> [from sequence]");
+            for (const auto& e : ChangeFeed::replay(argv[2], argc > 3 ? stoull(argv[3]) : 1)) ChangeFeed::print(cout, e);
+            return 0;
+        }
+#ifdef __linux__
+        // assign4 --bench <address> [clients] [requests per client] [pipeline depth] [request]
+        if (mode == "--bench") {
+            if (argc < 3) throw ServerException("Usage: --bench <address> [clients] [requests] [depth] [request]");
+            run_load_test(argv[2], argc > 3 ? atoi(argv[3]) : 8, argc > 4 ? atoi(argv[4]) : 10000,
+                argc > 5 ? atoi(argv[5]) : 32, argc > 6 ? argv[6] : "6 CS101");
+            return 0;
+        }
+#endif
         UniversitySystem uni;
+        if (!feed_path.empty()) uni.change_feed().open_sink(feed_path);
 
         date d1(1, 1, 2020);
         date d2(1, 6, 2021);
@@ -477,6 +3866,9 @@ int main() {
         uni.add_course(cs101);
         uni.add_course(cs102);
         uni.add_course(cs201);
+        uni.set_course_meeting_slots("CS101", TimeSlots::block(0, 9, 2) | TimeSlots::block(2, 9, 2));
+        uni.set_course_meeting_slots("CS102", TimeSlots::block(1, 10, 2) | TimeSlots::block(3, 10, 1));
+        uni.set_course_meeting_slots("CS201", TimeSlots::block(0, 10, 2) | TimeSlots::block(4, 14, 2));
 
         student* s1 = new GraduateStudent("Alice", 24, "S001", "9999999999", d1, "M.Tech", 3.8, "Dr. Smith", "AI & Ethics");
         student* s2 = new GraduateStudent("Bob", 25, "S002", "8888888888", d2, "M.Tech", 3.5, "Dr. Johnson", "Cyber Defense");
@@ -494,6 +3886,40 @@ int main() {
         uni.assign_grade("S002", 88.0);
         uni.assign_grade("S003", 75.0);
 
+        uni.upload_course_grades({ { "S001", "CS101", 95.0 }, { "S002", "CS101", 78.0 },
+            { "S002", "CS102", 85.0 }, { "S003", "CS201", 75.0 } });
+
+        uni.add_prerequisite("CS102", "CS101");
+        uni.add_prerequisite("CS201", "CS102");
+
+        uni.report_course_statistics();
+        uni.report_exam_schedule();
+        uni.report_integrity(true);
+
+        // assign4 --export <file> [--compress] writes the demo data as columnar batches
+        if (mode == "--export") {
+            if (argc < 3) throw UniversitySystemException("Usage: --export <file> [--compress]");
+            bool compress = argc > 3 && string(argv[3]) == "--compress";
+            uni.export_columnar(argv[2], 65536, compress);
+            ColumnarReader reader(argv[2]);
+            cout << "Exported students: " << reader.row_count(ExportTable::Students)
+                << ", courses: " << reader.row_count(ExportTable::Courses)
+                << ", enrollments: " << reader.row_count(ExportTable::Enrollments)
+                << ", grades: " << reader.row_count(ExportTable::Grades)
+                << ", course grades: " << reader.row_count(ExportTable::CourseGrades) << endl;
+            return 0;
+        }
+
+#ifdef __linux__
+        // assign4 --serve <address> serves the same data over a socket instead of the menu
+        if (mode == "--serve") {
+            if (argc < 3) throw ServerException("Usage: --serve unix:<path> | tcp:<port>");
+            UniversityServer server(uni, argv[2]);
+            cout << "Serving on " << argv[2] << endl;
+            server.run();
+            return 0;
+        }
+#endif
         uni.menu();
     }
     catch (const exception& e) {